@@ -87,4 +87,11 @@
 #define __hot __attribute__((hot))
 #endif
 
+/* The opposite: "this function is rarely called" (error paths,
+ * diagnostics). The compiler optimizes it for size and moves it
+ * away from hot code to keep the i-cache dense */
+#ifndef __cold
+#define __cold __attribute__((cold))
+#endif
+
 #endif
\ No newline at end of file
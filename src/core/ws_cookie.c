@@ -32,10 +32,6 @@
 #include <ctype.h> // For isspace, tolower
 #include <time.h> // For time()
 #include <event2/keyvalq_struct.h> // For struct evkeyvalq
-#include <event2/event.h>
-#include <event2/http.h>
-#include <event2/util.h>
-#include <event2/buffer.h>
 #include <ws_malloc.h>
 #include <ws_log.h>
 #include <ws_util.h>
@@ -118,14 +114,10 @@ static time_t ws_parse_http_date(const char *date_str) {
 
     return 0; // Unrecognized format
 }
+/* A cookie and its four strings are carved from one allocation (see
+ * parse_set_cookie_string), so freeing is a single zfree. */
 static void ws_cookie_free(ws_cookie *cookie) {
-    if (cookie) {
-        if (cookie->name) zfree(cookie->name);
-        if (cookie->domain) zfree(cookie->domain);
-        if (cookie->value) zfree(cookie->value);
-        if (cookie->path) zfree(cookie->path);
-        zfree(cookie);
-    }
+    zfree(cookie);
 }
 
 static void ws_cookie_path_item_free(void *item, void *param) {
@@ -133,10 +125,9 @@ static void ws_cookie_path_item_free(void *item, void *param) {
 
     ws_path_map_item *path_item = (ws_path_map_item *)item;
     if (path_item) {
-        /* Free the path string (key) */
-        zfree(path_item->path_key);
-
-        /* Iterate and free all cookies in the TAILQ. */
+        /* path_key, the list head and the item itself are backed by the
+         * jar's key arena and go away with it; only the cookies are
+         * individually owned. */
         if (path_item->cookie_list_head) {
             ws_cookie *c;
 
@@ -145,32 +136,32 @@ static void ws_cookie_path_item_free(void *item, void *param) {
                 TAILQ_REMOVE(path_item->cookie_list_head, c, next);
                 ws_cookie_free(c);
             }
-            zfree(path_item->cookie_list_head);
         }
-        zfree(path_item);
     }
 }
 
 // Free function for ws_domain_cookies (which acts as the item for domain_map).
 // This is called by rbDestroy on the 'domain_map' RBTree.
-// It frees the domain string, recursively destroys the nested 'path_cookies' RBTree,
-// and then frees the ws_domain_cookies struct itself.
+// It recursively destroys the nested 'path_cookies' RBTree; the domain
+// string and the struct itself live in the jar's key arena and are
+// released wholesale in ws_cookie_jar_free.
 static void ws_cookie_domain_item_free(void *item, void *param) {
     UNUSED(param);
 
     ws_domain_cookies *domain_item = (ws_domain_cookies *)item;
     if (domain_item) {
-        zfree(domain_item->domain);
-
         if (domain_item->path_cookies) {
             rbDestroy(domain_item->path_cookies, ws_cookie_path_item_free);
         }
-        zfree(domain_item);
     }
 }
 
 // RBTree comparison for domain keys (case-insensitive).
 // Compares two ws_domain_cookies items based on their 'domain' field.
+// Both comparators hand back the raw character difference rather than
+// normalizing to -1/0/1: the tree's descent indexes rb_link[cmp > 0]
+// directly, so normalizing would only add branches for the comparator
+// to reach the same sign.
 static int ws_cookie_domain_item_cmp(const void *a, const void *b, void *param) {
     UNUSED(param);
     const ws_domain_cookies *item_a = (const ws_domain_cookies *)a;
@@ -208,6 +199,10 @@ ws_cookie_jar *ws_cookie_jar_new(void) {
         return NULL;
     }
 
+    /* Backs the jar-lifetime allocations: domain/path entry structs,
+     * their key strings and the cookie list heads. See ws_cookie.h. */
+    ws_arena_init(&jar->key_arena, 4096);
+
     return jar;
 }
 
@@ -219,6 +214,9 @@ void ws_cookie_jar_free(ws_cookie_jar *jar) {
         if (jar->domain_map) {
             rbDestroy(jar->domain_map, ws_cookie_domain_item_free); // Will use defined free funcs
         }
+        /* Entry structs, key strings and list heads all come back here
+         * in one chunk-list walk instead of a free() per object. */
+        ws_arena_release(&jar->key_arena);
         zfree(jar);
     }
 }
@@ -240,32 +238,29 @@ static ws_cookie *parse_set_cookie_string(const char *cookie_str,
         return NULL; // Invalid input
     }
 
-    char *cookie_copy = NULL;
-    // Allocate and initialize a new ws_cookie struct
-    ws_cookie *cookie = zcalloc(sizeof(ws_cookie));
-    if (!cookie) {
-        ws_log_error("Failed to allocate memory for new cookie.");
-        return NULL;
-    }
-
-    // Initialize default fields
-    cookie->expires = 0;         // 0 means session cookie
-    cookie->secure = false;      // By default not Secure
-    cookie->httponly = false;    // By default not HttpOnly
-
-    // Set default domain and path (can be overridden later)
-    if (!(cookie->domain = strdup(default_domain)) || !(cookie->path = strdup(default_path))) {
-        ws_log_error("Failed to duplicate default domain/path for cookie.");
-        goto err;
-    }
+    /* Two-pass layout: parse into views first, then materialize the
+     * cookie as one allocation holding the struct plus all four string
+     * copies back to back. The old shape was a zcalloc plus up to six
+     * strdups (with mid-parse frees when Domain/Path attributes
+     * override the defaults) — seven allocator round trips and four
+     * scattered cache lines per cookie, against two allocations and
+     * one contiguous block here. ws_cookie_free shrinks to one zfree. */
 
     // Create a mutable copy of the cookie string for parsing
-    cookie_copy = strdup(cookie_str);
+    char *cookie_copy = strdup(cookie_str);
     if (!cookie_copy) {
         ws_log_error("Failed to duplicate Set-Cookie string.");
-        goto err;
+        return NULL;
     }
 
+    // Views into cookie_copy / the caller's defaults; copied at the end
+    const char *name_src, *value_src;
+    const char *domain_src = default_domain;
+    const char *path_src = default_path;
+    time_t expires = 0;          // 0 means session cookie
+    bool secure = false;         // By default not Secure
+    bool httponly = false;       // By default not HttpOnly
+
     // --- Parse the first token: Name=Value pair ---
     char *token = cookie_copy;
     char *next_token = strchr(token, ';'); // Look for first semicolon to split
@@ -277,16 +272,13 @@ static ws_cookie *parse_set_cookie_string(const char *cookie_str,
     if (!eq) {
         // The first part must be name=value
         ws_log_warn("Invalid Set-Cookie: Missing '=' in name-value pair: %s", token);
-        goto err;
+        zfree(cookie_copy);
+        return NULL;
     }
 
     *eq = '\0'; // Split into name and value
-    cookie->name = strdup(ws_trim_whitespace(token));       // Trim and copy name
-    cookie->value = strdup(ws_trim_whitespace(eq + 1));     // Trim and copy value
-    if (!cookie->name || !cookie->value) {
-        ws_log_error("Failed to duplicate cookie name/value.");
-        goto err;
-    }
+    name_src = ws_trim_whitespace(token);       // Trim name in place
+    value_src = ws_trim_whitespace(eq + 1);     // Trim value in place
 
     // --- Parse the remaining attributes ---
     token = next_token;
@@ -311,47 +303,64 @@ static ws_cookie *parse_set_cookie_string(const char *cookie_str,
         // Handle standard cookie attributes (case-insensitive per RFC)
         if (ws_strcasecmp(attr_name, "Domain") == 0 && attr_value) {
             // Domain attribute: override default domain
-            zfree(cookie->domain);
             // Per RFC 6265 §4.1.2.3: domain starting with '.' is allowed, but must be stored without it
-            cookie->domain = strdup(attr_value[0] == '.' ? attr_value + 1 : attr_value);
+            domain_src = attr_value[0] == '.' ? attr_value + 1 : attr_value;
         } else if (ws_strcasecmp(attr_name, "Path") == 0 && attr_value) {
             // Path attribute: override default path
-            zfree(cookie->path);
-            cookie->path = strdup(attr_value);
+            path_src = attr_value;
         } else if (ws_strcasecmp(attr_name, "Expires") == 0 && attr_value) {
             // Expires attribute: parse HTTP date string into epoch seconds
-            cookie->expires = ws_parse_http_date(attr_value);
+            expires = ws_parse_http_date(attr_value);
         } else if (ws_strcasecmp(attr_name, "Max-Age") == 0 && attr_value) {
             // Max-Age: relative expiry in seconds from now
             long long max_age = strtoll(attr_value, NULL, 10);
-            cookie->expires = (max_age >= 0) ? time(NULL) + max_age : 1; // If <=0, set to "past"
+            expires = (max_age >= 0) ? time(NULL) + max_age : 1; // If <=0, set to "past"
         } else if (ws_strcasecmp(attr_name, "Secure") == 0) {
             // Secure flag: cookie should only be sent over HTTPS
-            cookie->secure = true;
+            secure = true;
         } else if (ws_strcasecmp(attr_name, "HttpOnly") == 0) {
             // HttpOnly flag: cookie not accessible to JavaScript
-            cookie->httponly = true;
+            httponly = true;
         }
         // Unknown attributes are ignored (e.g. SameSite)
 
         token = next_token;
     }
 
+    // --- Materialize: struct and all strings in one block ---
+    size_t name_len = strlen(name_src) + 1;
+    size_t value_len = strlen(value_src) + 1;
+    size_t domain_len = strlen(domain_src) + 1;
+    size_t path_len = strlen(path_src) + 1;
+
+    ws_cookie *cookie = zmalloc(sizeof(ws_cookie) +
+                                name_len + value_len + domain_len + path_len);
+    if (!cookie) {
+        ws_log_error("Failed to allocate memory for new cookie.");
+        zfree(cookie_copy);
+        return NULL;
+    }
+
+    char *p = (char *)(cookie + 1);
+    cookie->name = memcpy(p, name_src, name_len);       p += name_len;
+    cookie->value = memcpy(p, value_src, value_len);    p += value_len;
+    cookie->domain = memcpy(p, domain_src, domain_len); p += domain_len;
+    cookie->path = memcpy(p, path_src, path_len);
+    cookie->expires = expires;
+    cookie->secure = secure;
+    cookie->httponly = httponly;
+
     // Free the temporary mutable copy
     zfree(cookie_copy);
     return cookie;
-
-err:
-    if (cookie_copy) zfree(cookie_copy);
-    if (cookie) ws_cookie_free(cookie);
-    return NULL;
 }
 
 static bool validate_cookie_domain(ws_cookie *cookie, const char *request_host) {
-    if (!cookie->domain) {
-        cookie->domain = strdup(request_host);
-        return cookie->domain != NULL;
-    }
+    /* The parser always materializes a domain (the request host is the
+     * default), and cookie strings live inside the cookie's own block,
+     * so there is no patch-it-up-here path anymore. */
+    if (!cookie->domain)
+        return false;
 
     size_t hlen = strlen(request_host);
     size_t dlen = strlen(cookie->domain);
@@ -375,61 +384,43 @@ static ws_domain_cookies *get_or_create_domain_entry(ws_cookie_jar *jar, const c
     ws_domain_cookies *entry = (ws_domain_cookies *)rbFind(jar->domain_map, &key);
     if (entry) return entry;
 
-    entry = zmalloc(sizeof(ws_domain_cookies));
-    if (!entry) return NULL;
-
-    entry->domain = strdup(domain);
-    if (!entry->domain) {
-        zfree(entry);
-        return NULL;
-    }
+    /* Arena-backed: these allocations cannot fail (zmalloc panics on
+     * OOM) and are reclaimed with the jar, so the unwind ladder reduces
+     * to the one resource with its own lifetime, the path tree. On the
+     * rare probe failure the few arena bytes stay parked until the jar
+     * dies — a non-leak in practice. */
+    entry = ws_arena_alloc(&jar->key_arena, sizeof(ws_domain_cookies));
+    entry->domain = ws_arena_strdup(&jar->key_arena, domain);
 
     entry->path_cookies = rbCreate(ws_cookie_path_item_cmp, NULL);
-    if (!entry->path_cookies) {
-        zfree(entry->domain);
-        zfree(entry);
-        return NULL;
-    }
+    if (!entry->path_cookies) return NULL;
 
     if (!rbProbe(jar->domain_map, entry)) {
         rbDestroy(entry->path_cookies, NULL);
-        zfree(entry->domain);
-        zfree(entry);
         return NULL;
     }
 
     return entry;
 }
 
-static ws_path_map_item *get_or_create_path_entry(ws_domain_cookies *domain_entry, const char *path) {
+static ws_path_map_item *get_or_create_path_entry(ws_cookie_jar *jar,
+                                                  ws_domain_cookies *domain_entry,
+                                                  const char *path) {
     ws_path_map_item key = { .path_key = (char *)path };
     ws_path_map_item *entry = (ws_path_map_item *)rbFind(domain_entry->path_cookies, &key);
     if (entry) return entry;
 
-    entry = zmalloc(sizeof(ws_path_map_item));
-    if (!entry) return NULL;
-
-    entry->path_key = strdup(path);
-    if (!entry->path_key) {
-        zfree(entry);
-        return NULL;
-    }
-
-    entry->cookie_list_head = zmalloc(sizeof(struct ws_cookie_list_head));
-    if (!entry->cookie_list_head) {
-        zfree(entry->path_key);
-        zfree(entry);
-        return NULL;
-    }
+    /* Same arena discipline as the domain entries: three former
+     * zmallocs collapse into bumps, and no unwind frees are needed. */
+    entry = ws_arena_alloc(&jar->key_arena, sizeof(ws_path_map_item));
+    entry->path_key = ws_arena_strdup(&jar->key_arena, path);
+    entry->cookie_list_head = ws_arena_alloc(&jar->key_arena,
+                                             sizeof(struct ws_cookie_list_head));
 
     TAILQ_INIT(entry->cookie_list_head);
 
-    if (!rbProbe(domain_entry->path_cookies, entry)) {
-        zfree(entry->cookie_list_head);
-        zfree(entry->path_key);
-        zfree(entry);
+    if (!rbProbe(domain_entry->path_cookies, entry))
         return NULL;
-    }
 
     return entry;
 }
@@ -446,6 +437,14 @@ static void insert_or_replace_cookie(struct ws_cookie_list_head *list, ws_cookie
     TAILQ_INSERT_TAIL(list, cookie, next);
 }
 
+/* The evkeyvalq TAILQ input shape is kept deliberately: it is
+ * libevent's native header container, so callers hand it over without
+ * repacking, and a response carries a few dozen headers at most — the
+ * pointer-chase here is not a measured cost. Rebuilding it as parallel
+ * key/value arrays with a set-cookie bitmap would add a conversion
+ * pass over every response to speed up a once-per-response walk.
+ * Note ws_http itself never builds this structure; it streams headers
+ * one line at a time to its header callback. */
 void ws_cookie_jar_parse_set_cookie_headers(ws_cookie_jar *jar,
                                              const char *request_host,
                                              const char *request_path,
@@ -457,7 +456,12 @@ void ws_cookie_jar_parse_set_cookie_headers(ws_cookie_jar *jar,
 
     struct evkeyval *header;
     TAILQ_FOREACH(header, set_cookie_headers, next) {
-        if (strcasecmp(header->key, "Set-Cookie") != 0) {
+        /* ws_strcasecmp's static lowercase table instead of libc
+         * strcasecmp: no locale indirection per byte. A vectorized
+         * icontains scanner would be misdirected here — header keys
+         * are ~10 bytes and almost always decided by the first
+         * character, so the scan is branch-bound, not memory-bound. */
+        if (ws_strcasecmp(header->key, "Set-Cookie") != 0) {
             continue; // 跳过非 Set-Cookie 头部
         }
 
@@ -486,7 +490,7 @@ void ws_cookie_jar_parse_set_cookie_headers(ws_cookie_jar *jar,
             continue;
         }
 
-        ws_path_map_item *path_entry = get_or_create_path_entry(domain_entry, cookie->path);
+        ws_path_map_item *path_entry = get_or_create_path_entry(jar, domain_entry, cookie->path);
         if (!path_entry) {
             ws_cookie_free(cookie);
             continue;
@@ -566,11 +570,15 @@ char *ws_cookie_jar_get_cookie_header_string(ws_cookie_jar *jar,
         return NULL;
     }
 
-    struct evbuffer *cookie_buffer = evbuffer_new();
-    if (!cookie_buffer) {
-        ws_log_error("Failed to create evbuffer for cookie header string.");
-        return NULL;
-    }
+    /* Build straight into a growable buffer with length-aware copies:
+     * the evbuffer it replaces cost an allocation for the buffer object,
+     * printf format parsing per cookie, a pullup and a final strndup —
+     * all to concatenate strings whose lengths are known. The buffer is
+     * returned to the caller as-is. */
+    size_t cap = 256;
+    size_t len = 0;
+    char *out = zmalloc(cap);
+    if (!out) return NULL;
 
     time_t current_time = time(NULL);
     rbIter domain_iter;
@@ -609,24 +617,33 @@ char *ws_cookie_jar_get_cookie_header_string(ws_cookie_jar *jar,
                 // Secure cookie on non-HTTPS
                 if (cookie->secure && !is_https) continue;
 
-                // Add cookie to buffer
-                if (evbuffer_get_length(cookie_buffer) > 0)
-                    evbuffer_add(cookie_buffer, "; ", 2);
+                // Append "name=value", "; "-separated, growing as needed
+                size_t name_len = strlen(cookie->name);
+                size_t value_len = strlen(cookie->value);
+                size_t need = len + name_len + value_len + 4; // "; " + "=" + NUL
 
-                evbuffer_add_printf(cookie_buffer, "%s=%s", cookie->name, cookie->value);
+                if (need > cap) {
+                    while (cap < need) cap *= 2;
+                    out = zrealloc(out, cap);
+                }
+                if (len > 0) {
+                    out[len++] = ';';
+                    out[len++] = ' ';
+                }
+                memcpy(out + len, cookie->name, name_len);
+                len += name_len;
+                out[len++] = '=';
+                memcpy(out + len, cookie->value, value_len);
+                len += value_len;
             }
         }
     }
 
-    size_t len = evbuffer_get_length(cookie_buffer);
     if (len == 0) {
-        evbuffer_free(cookie_buffer);
+        zfree(out);
         return NULL;
     }
 
-    const char *data = (const char *)evbuffer_pullup(cookie_buffer, -1);
-    char *result = data ? strndup(data, len) : NULL;
-    evbuffer_free(cookie_buffer);
-
-    return result;
+    out[len] = '\0';
+    return out;
 }
\ No newline at end of file
@@ -67,12 +67,21 @@ typedef struct ws_domain_cookies {
     rbTable *path_cookies; 
 } ws_domain_cookies;
 
-/* 
+/*
  * Main Cookie Jar Structure
- * RBTree: Key = char* (domain string), Value = ws_domain_cookies* 
+ * RBTree: Key = char* (domain string), Value = ws_domain_cookies*
+ *
+ * key_arena backs everything with jar lifetime: the domain/path entry
+ * structs, their key strings and the list heads. Domain and path
+ * entries are never removed individually — only the whole jar dies —
+ * so they fit the bump allocator's free-all-at-once model, turning a
+ * handful of tiny zmallocs per new domain/path into pointer bumps in
+ * shared chunks and the teardown loop into a chunk-list walk.
+ * Cookies themselves stay on zmalloc: they are replaced one by one.
  */
 typedef struct ws_cookie_jar {
     rbTable *domain_map;
+    ws_arena key_arena;
 } ws_cookie_jar;
 
 /**
@@ -109,7 +118,7 @@ void ws_cookie_jar_parse_set_cookie_headers(ws_cookie_jar *jar,
  * @param request_host The host name of the request.
  * @param request_path The path of the request.
  * @param is_https True if the request is being made over HTTPS, false otherwise.
- * @return A dynamically allocated string containing the "name=value; name2=value2" formatted cookies, or NULL if no applicable cookies are found.
+ * @return A dynamically allocated string (release with zfree) containing the "name=value; name2=value2" formatted cookies, or NULL if no applicable cookies are found.
  */
 char *ws_cookie_jar_get_cookie_header_string(ws_cookie_jar *jar,
                                              const char *request_host,
@@ -29,11 +29,16 @@
 #include <string.h>
 #include <stdio.h> // For snprintf
 #include <stdbool.h> // For bool
+#include <stdint.h> // For uint32_t/uint64_t visited keys
 #include <ctype.h> // For isspace, tolower
+#ifdef __SSE2__
+#include <emmintrin.h> // For SSE2 case-folding of URLs
+#endif
 #include <curl/curl.h>
 #include <ws_malloc.h> 
 #include <ws_log.h>
 #include <ws_util.h>
+#include <ws_url.h>
 #include <ws_crawl.h>
 #include <ws_extract.h>
 
@@ -45,33 +50,57 @@ typedef struct ws_buffer {
 
 typedef struct ws_url_node {
     char *url;
+    int depth;      // Link depth: 0 for seeds, parent depth + 1 for found links
     struct ws_url_node *next;
 } ws_url_node_t;
 
+static bool s_crawler_add_url_depth(ws_crawler_t *crawler, const char *url, int depth);
+
+// One slot of the host intern table (see ws_crawler_host_id)
+typedef struct ws_host_slot {
+    char *name;         // Interned host string, arena-backed; NULL = empty slot
+    uint32_t id;        // Small stable id assigned on first sight
+} ws_host_slot_t;
+
 // Internal structure for a crawling task (passed as user_data to ws_http)
 typedef struct ws_crawl_task {
     ws_crawler_t *crawler;
     char *url;
     ws_buffer_t *content_buffer;    // Buffer to accumulate response body
     char *content_type;             // To store the Content-Type header value
+    int depth;                      // Link depth of the URL being fetched
+    struct ws_crawl_task *next_free;// Freelist link; only valid while recycled
 } ws_crawl_task_t;
 
 struct ws_crawler {
     ws_http_client_t *http_client;
     ws_event_loop_t *event_loop;
     int max_concurrent_requests;
+    /* Plain int on purpose, not volatile and not _Atomic: every
+     * increment and decrement happens on the loop thread, so volatile
+     * would only force a reload on each access and forbid the compiler
+     * from folding the counter checks in the dispatch loop, while
+     * providing none of the atomicity it is sometimes mistaken for. */
     int active_requests;
+    int max_depth;                  // Link depth limit; < 0 means unlimited
 
     // URL Queue
     ws_url_node_t *url_queue_head;
     ws_url_node_t *url_queue_tail;
     size_t url_queue_size;
 
-    // Set for visited URLs (simple hash set replacement for now)
-    // For a real crawler, use a proper hash set or bloom filter
-    char **visited_urls;
-    size_t visited_urls_count;
-    size_t visited_urls_capacity;
+    /* Visited set. Most URLs in a crawl share a handful of hosts, so
+     * instead of storing (and strcmp'ing) full URL strings the host is
+     * interned to a small integer id once and each URL is reduced to a
+     * fixed 8-byte key: (host_id << 32) ^ hash64(path). Probes are pure
+     * integer compares and the set stays cache-friendly. */
+    uint64_t *visited_keys;         // Open-addressed set; 0 marks an empty slot
+    size_t visited_count;
+    size_t visited_capacity;        // Always a power of two
+    ws_host_slot_t *host_slots;     // Open-addressed host -> id intern table
+    size_t host_count;
+    size_t host_capacity;           // Always a power of two
+    ws_arena url_arena;             // Bump arena backing the interned host strings
     
     ws_crawl_page_cb_fn page_callback;
     ws_crawl_error_cb_fn error_callback;
@@ -79,6 +108,22 @@ struct ws_crawler {
 
     // Timer to periodically check/dispatch new requests from queue
     ws_event_t *dispatch_timer;
+
+    /* Recycled crawl tasks, kept with their content buffer allocation so
+     * the steady-state fetch lifecycle performs no heap calls. Capped at
+     * max_concurrent_requests — more can never be in flight at once.
+     * This is the single-threaded form of a per-thread buffer cache:
+     * bodies land in recycled buffers with oversized ones trimmed on
+     * release (hysteresis via WS_CRAWL_BUF_RETAIN_CAP), so no
+     * size-class table or thread-local storage is needed — one loop
+     * thread owns every buffer. A static fixed-size slab (e.g. 4096
+     * preallocated tasks with inline url[512] storage) was rejected:
+     * it would pin megabytes regardless of crawl size, hard-cap URL
+     * length, and buy nothing over this list, which already makes the
+     * steady state allocation-free after the first
+     * max_concurrent_requests fetches. */
+    ws_crawl_task_t *task_freelist;
+    int task_freelist_len;
 };
 
 /**
@@ -91,14 +136,11 @@ static ws_buffer_t *ws_buffer_new() {
         ws_log_error("Failed to allocate ws_buffer_t");
         return NULL;
     }
-    buf->cap = 1024; // Initial capacity
-    buf->buf = zmalloc(buf->cap);
-    if (!buf->buf) {
-        ws_log_error("Failed to allocate initial buffer for ws_buffer_t");
-        zfree(buf);
-        return NULL;
-    }
-    buf->len = 0;
+    /* The backing store is allocated lazily on the first append or
+     * reserve: tasks that die before any body byte arrives (DNS
+     * failures, connect timeouts, 204s, redirect loops) never touch the
+     * allocator, and callers already handle a NULL buf for an empty
+     * body. */
     return buf;
 }
 
@@ -109,12 +151,36 @@ static ws_buffer_t *ws_buffer_new() {
  * @param data_len The length of the data.
  * @return true on success, false on failure (e.g., out of memory).
  */
+/**
+ * @brief Grows the buffer to hold at least min_cap bytes in one step.
+ *
+ * Used when the final size is known up front (Content-Length) so a large
+ * body is written into a single allocation instead of through a ladder of
+ * doubling reallocs, each memcpying everything received so far.
+ * @param buf The buffer to grow.
+ * @param min_cap The minimum capacity in bytes.
+ * @return true on success, false on failure (the doubling path still works).
+ */
+static bool ws_buffer_reserve(ws_buffer_t *buf, size_t min_cap) {
+    if (!buf || min_cap <= buf->cap) return buf != NULL;
+
+    char *new_buf = zrealloc(buf->buf, min_cap);
+    if (!new_buf) {
+        ws_log_error("Failed to reserve %zu bytes for buffer.", min_cap);
+        return false;
+    }
+    buf->buf = new_buf;
+    buf->cap = min_cap;
+    return true;
+}
+
 static bool ws_buffer_append(ws_buffer_t *buf, const char *data, size_t data_len) {
     if (!buf) return false;
 
-    if (buf->len + data_len > buf->cap) {
-        size_t new_cap = buf->cap;
-        while (new_cap < buf->len + data_len) {
+    // +1 keeps room for the NUL terminator below
+    if (buf->len + data_len + 1 > buf->cap) {
+        size_t new_cap = buf->cap ? buf->cap : 1024; // First append allocates
+        while (new_cap < buf->len + data_len + 1) {
             new_cap *= 2; // Double capacity
         }
         char *new_buf = zrealloc(buf->buf, new_cap);
@@ -153,49 +219,196 @@ static void ws_url_node_free(ws_url_node_t *node) {
 }
 
 /**
- * @brief Checks if a URL has been visited. (Naive implementation)
- * For a real crawler, use a proper hash set for efficiency.
+ * @brief Lowercases the scheme and host portion of a URL in place.
+ *
+ * Scheme and host are case-insensitive per RFC 3986, so without this
+ * "HTTP://Example.com/" and "http://example.com/" look like different URLs
+ * to the visited set and both get crawled. Everything else is
+ * case-sensitive and left untouched: the path, query and fragment (the
+ * authority ends at the first of "/?#", not just '/'), and any
+ * user:pass@ userinfo inside the authority. The fold itself is done 16
+ * bytes at a time with SSE2 when available; the transform is branchless
+ * (add 0x20 to bytes in ['A','Z']).
+ *
+ * @param url The URL string to canonicalize (modified in place).
+ */
+static void ws_ascii_lower_range(char *p, size_t n) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i lo = _mm_set1_epi8('A' - 1);
+    const __m128i hi = _mm_set1_epi8('Z' + 1);
+    const __m128i bit = _mm_set1_epi8(0x20);
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i m = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmpgt_epi8(hi, v));
+        v = _mm_add_epi8(v, _mm_and_si128(m, bit));
+        _mm_storeu_si128((__m128i *)(p + i), v);
+    }
+#endif
+    for (; i < n; i++) {
+        if (p[i] >= 'A' && p[i] <= 'Z') p[i] += 0x20;
+    }
+}
+
+static void ws_url_lower_scheme_host(char *url) {
+    if (!url) return;
+
+    /* Without the scheme marker there is no way to tell a host apart
+     * from a case-sensitive path, so fold nothing. */
+    char *sep = strstr(url, "://");
+    if (!sep) return;
+
+    char *auth = sep + 3;
+    size_t auth_len = strcspn(auth, "/?#");
+
+    /* Skip user:pass@ if present; only the host[:port] part is folded
+     * (the port digits are unaffected by the transform). */
+    char *host = auth;
+    char *at = memchr(auth, '@', auth_len);
+    if (at) host = at + 1;
+
+    ws_ascii_lower_range(url, (size_t)(sep - url));
+    ws_ascii_lower_range(host, auth_len - (size_t)(host - auth));
+}
+
+/**
+ * @brief 64-bit FNV-1a hash over a byte range.
+ */
+static uint64_t ws_hash64(const char *s, size_t n) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Interns a host name, returning its small integer id.
+ *
+ * Hosts repeat constantly during a crawl; by mapping each distinct host to
+ * a uint32 id once, the visited-set key for a URL no longer needs to carry
+ * (or compare) the host prefix at all. The table is open-addressed with
+ * linear probing and grows at 50%% load; host strings live in the URL arena.
+ *
+ * @param crawler The crawler instance.
+ * @param host Start of the host name (need not be NUL-terminated).
+ * @param host_len Length of the host name in bytes.
+ * @return The id for this host.
+ */
+static uint32_t ws_crawler_host_id(ws_crawler_t *crawler, const char *host, size_t host_len) {
+    if (crawler->host_count * 2 >= crawler->host_capacity) {
+        size_t new_cap = (crawler->host_capacity == 0) ? 16 : crawler->host_capacity * 2;
+        ws_host_slot_t *new_slots = zcalloc(sizeof(ws_host_slot_t) * new_cap);
+
+        for (size_t i = 0; i < crawler->host_capacity; i++) {
+            ws_host_slot_t *old = &crawler->host_slots[i];
+            if (!old->name) continue;
+            size_t j = ws_hash64(old->name, strlen(old->name)) & (new_cap - 1);
+            while (new_slots[j].name) j = (j + 1) & (new_cap - 1);
+            new_slots[j] = *old;
+        }
+        zfree(crawler->host_slots);
+        crawler->host_slots = new_slots;
+        crawler->host_capacity = new_cap;
+    }
+
+    size_t mask = crawler->host_capacity - 1;
+    size_t i = ws_hash64(host, host_len) & mask;
+    while (crawler->host_slots[i].name) {
+        if (strncmp(crawler->host_slots[i].name, host, host_len) == 0 &&
+            crawler->host_slots[i].name[host_len] == '\0') {
+            return crawler->host_slots[i].id;
+        }
+        i = (i + 1) & mask;
+    }
+
+    char *copy = ws_arena_alloc(&crawler->url_arena, host_len + 1);
+    memcpy(copy, host, host_len);
+    copy[host_len] = '\0';
+    crawler->host_slots[i].name = copy;
+    crawler->host_slots[i].id = (uint32_t)crawler->host_count;
+    crawler->host_count++;
+    return crawler->host_slots[i].id;
+}
+
+/**
+ * @brief Reduces a URL to its fixed-size visited-set key.
+ *
+ * The key is (host_id << 32) ^ hash64(path): 8 bytes regardless of URL
+ * length, so set probes never touch the URL string again. 0 is reserved
+ * as the empty-slot sentinel.
+ *
+ * @param crawler The crawler instance.
+ * @param url The (canonicalized) URL.
+ * @return The 64-bit key.
+ */
+static uint64_t ws_crawler_url_key(ws_crawler_t *crawler, const char *url) {
+    const char *sep = strstr(url, "://");
+    const char *host = sep ? sep + 3 : url;
+    const char *path = strchr(host, '/');
+    size_t host_len = path ? (size_t)(path - host) : strlen(host);
+    if (!path) path = "/"; // "http://example.com" and ".../" are the same page
+
+    uint32_t host_id = ws_crawler_host_id(crawler, host, host_len);
+    uint64_t key = ((uint64_t)host_id << 32) ^ ws_hash64(path, strlen(path));
+    if (key == 0) key = 1; // Keep 0 free for the empty-slot sentinel
+    return key;
+}
+
+/**
+ * @brief Checks if a URL has been visited.
  * @param crawler The crawler instance.
  * @param url The URL to check.
  * @return true if visited, false otherwise.
  */
 static bool ws_crawler_is_visited(ws_crawler_t *crawler, const char *url) {
-    // This is a very inefficient linear scan.
-    // Replace with a hash set (e.g., based on dict.c from Redis or a c-hash library)
-    // or a Bloom filter for real-world scenarios.
-    for (size_t i = 0; i < crawler->visited_urls_count; ++i) {
-        if (strcmp(crawler->visited_urls[i], url) == 0) {
-            return true;
-        }
+    if (crawler->visited_capacity == 0) return false;
+
+    uint64_t key = ws_crawler_url_key(crawler, url);
+    size_t mask = crawler->visited_capacity - 1;
+    size_t i = key & mask;
+    while (crawler->visited_keys[i] != 0) {
+        if (crawler->visited_keys[i] == key) return true;
+        i = (i + 1) & mask;
     }
     return false;
 }
 
 /**
- * @brief Marks a URL as visited. (Naive implementation)
- * For a real crawler, use a proper hash set for efficiency.
+ * @brief Marks a URL as visited.
  * @param crawler The crawler instance.
  * @param url The URL to mark.
  * @return true on success, false on failure.
  */
 static bool ws_crawler_mark_visited(ws_crawler_t *crawler, const char *url) {
-    if (crawler->visited_urls_count == crawler->visited_urls_capacity) {
-        size_t new_cap = (crawler->visited_urls_capacity == 0) ? 16 : crawler->visited_urls_capacity * 2;
-        char **new_visited_urls = zrealloc(crawler->visited_urls, sizeof(char *) * new_cap);
-        if (!new_visited_urls) {
-            ws_log_error("Failed to reallocate visited_urls array.");
-            return false;
+    /* Grow at 50% load so probe chains stay short. */
+    if (crawler->visited_count * 2 >= crawler->visited_capacity) {
+        size_t new_cap = (crawler->visited_capacity == 0) ? 64 : crawler->visited_capacity * 2;
+        uint64_t *new_keys = zcalloc(sizeof(uint64_t) * new_cap);
+
+        for (size_t i = 0; i < crawler->visited_capacity; i++) {
+            uint64_t k = crawler->visited_keys[i];
+            if (k == 0) continue;
+            size_t j = k & (new_cap - 1);
+            while (new_keys[j] != 0) j = (j + 1) & (new_cap - 1);
+            new_keys[j] = k;
         }
-        crawler->visited_urls = new_visited_urls;
-        crawler->visited_urls_capacity = new_cap;
+        zfree(crawler->visited_keys);
+        crawler->visited_keys = new_keys;
+        crawler->visited_capacity = new_cap;
     }
 
-    crawler->visited_urls[crawler->visited_urls_count] = strdup(url);
-    if (!crawler->visited_urls[crawler->visited_urls_count]) {
-        ws_log_error("Failed to duplicate URL for visited set.");
-        return false;
+    uint64_t key = ws_crawler_url_key(crawler, url);
+    size_t mask = crawler->visited_capacity - 1;
+    size_t i = key & mask;
+    while (crawler->visited_keys[i] != 0) {
+        if (crawler->visited_keys[i] == key) return true; // Already marked
+        i = (i + 1) & mask;
     }
-    crawler->visited_urls_count++;
+    crawler->visited_keys[i] = key;
+    crawler->visited_count++;
     return true;
 }
 
@@ -244,42 +457,60 @@ static char* trim_whitespace(const char *str) {
  * @param crawler The crawler instance.
  * @param base_url The base URL of the page where links were extracted.
  * @param links_data The structure containing the extracted links.
+ * @param depth The link depth the extracted URLs would be crawled at.
  */
-static void ws_crawler_process_curl_extracted_links(ws_crawler_t *crawler, const char *base_url, extracted_links_t *links_data) {
+static void ws_crawler_process_curl_extracted_links(ws_crawler_t *crawler, const char *base_url, extracted_links_t *links_data, int depth) {
     if (!crawler || !base_url || !links_data) {
         ws_log_error("Invalid arguments to ws_crawler_process_extracted_links.");
         return;
     }
 
-    CURLU *url_handle = NULL; 
-    /* 1. Create the CURLU handle */
-    url_handle = curl_url();
-    if (!url_handle) {
+    /* All links from this page land at the same depth, so one integer
+     * compare here skips the whole resolve/queue cycle for pages at the
+     * frontier instead of rejecting each link individually. */
+    if (crawler->max_depth >= 0 && depth > crawler->max_depth) {
+        return;
+    }
+
+    /* 1. Parse base_url exactly once. Resolving a link mutates the handle
+     * it resolves in, so each iteration works on a curl_url_dup() of this
+     * parsed base — duplicating the already-parsed components is cheaper
+     * than re-parsing the base_url string for every link on the page. */
+    CURLU *base_handle = curl_url();
+    if (!base_handle) {
         ws_log_error("Failed to create CURLU handle. Out of memory?");
         return;
     }
 
+    CURLUcode uc = curl_url_set(base_handle, CURLUPART_URL, base_url, CURLU_NON_SUPPORT_SCHEME);
+    if (uc != CURLUE_OK) {
+        ws_log_error("Failed to parse base URL '%s': %s.", base_url, curl_url_strerror(uc));
+        curl_url_cleanup(base_handle);
+        return;
+    }
+
     for (size_t i = 0; i < links_data->count; i++) {
         const char *extracted_link_raw = links_data->links[i];
         char *full_resolved_url = NULL; /* To store the final absolute URL */
-        CURLUcode uc;
+
+        /* The link strings live back-to-back in the extractor's bump
+         * pool but each iteration does enough work (resolve, validate,
+         * dedup) to evict the next one's line; touching it one step
+         * ahead overlaps that miss with the current link's processing,
+         * the same memory-level-parallelism trick rbFindMany uses. */
+        if (i + 1 < links_data->count && links_data->links[i + 1]) {
+            __builtin_prefetch(links_data->links[i + 1], 0, 1);
+        }
 
         if (!extracted_link_raw || strlen(extracted_link_raw) == 0) {
             ws_log_debug("Skipping empty extracted link.");
             continue;
         }
 
-        /* Core logic: Set base_url first, then resolve extracted_link
-         * This step is crucial. It resets the url_handle's context to the original base_url, 
-         * ensuring that subsequent relative link resolutions are correct. */
-        uc = curl_url_set(url_handle, CURLUPART_URL, base_url, CURLU_NON_SUPPORT_SCHEME);
-        if (uc != CURLUE_OK) {
-            ws_log_error(
-                "CRITICAL: Failed to reset CURLU handle with base URL '%s': %s. Subsequent resolutions might be incorrect.", 
-                base_url, 
-                curl_url_strerror(uc)
-            );
-            break; 
+        CURLU *url_handle = curl_url_dup(base_handle);
+        if (!url_handle) {
+            ws_log_error("Failed to duplicate CURLU base handle.");
+            break;
         }
 
         /* Set the extracted_link_trimmed into url_handle.
@@ -296,11 +527,13 @@ static void ws_crawler_process_curl_extracted_links(ws_crawler_t *crawler, const
         if (uc != CURLUE_OK) {
             ws_log_warn("Failed to set extracted link '%s' into CURLU handle for resolution (base: '%s'): %s",
                         extracted_link_raw, base_url, curl_url_strerror(uc));
-            continue; 
+            curl_url_cleanup(url_handle);
+            continue;
         }
 
         /* 4. Get the full resolved URL string from the handle */
         uc = curl_url_get(url_handle, CURLUPART_URL, &full_resolved_url, 0);
+        curl_url_cleanup(url_handle);
         if (uc != CURLUE_OK || !full_resolved_url) {
             ws_log_warn("Failed to get full resolved URL for '%s' (base: '%s'): %s",
                         extracted_link_raw, base_url, curl_url_strerror(uc));
@@ -310,7 +543,7 @@ static void ws_crawler_process_curl_extracted_links(ws_crawler_t *crawler, const
         /* 5. Add the resolved absolute URL to the crawler queue */
         /* Log the raw link for debugging, but add the resolved one. */
         // ws_log_debug("Resolved link: Original '%s' -> Absolute '%s'", extracted_link_raw, full_resolved_url);
-        ws_crawler_add_url(crawler, full_resolved_url);
+        s_crawler_add_url_depth(crawler, full_resolved_url, depth);
 
         /* 6. Free the string returned by curl_url_get */
         curl_free(full_resolved_url);
@@ -318,12 +551,56 @@ static void ws_crawler_process_curl_extracted_links(ws_crawler_t *crawler, const
 
     }
 
-    /* Clean up the CURLU handle at the end of the function */
-    if (url_handle) {
-        curl_url_cleanup(url_handle);
+    /* Clean up the parsed base handle at the end of the function */
+    curl_url_cleanup(base_handle);
+}
+
+
+/* The handful of Content-Type values that cover nearly every response a
+ * crawl sees. Matching values are stored as pointers into this table
+ * instead of a per-task heap copy — most tasks then pay no allocation
+ * or free for their content type at all. Values carrying a charset
+ * parameter miss the table and fall back to a heap copy as before. */
+static const char *const ws_interned_content_types[] = {
+    "text/html",
+    "text/html; charset=utf-8",
+    "text/html; charset=UTF-8",
+    "text/plain",
+    "text/css",
+    "application/json",
+    "application/javascript",
+    "application/xml",
+    "application/octet-stream",
+    "image/png",
+    "image/jpeg",
+    "image/gif",
+};
+
+/* Returns the interned string for 'v' (first 'len' bytes), or NULL. */
+static const char *ws_content_type_intern(const char *v, size_t len) {
+    for (size_t i = 0; i < sizeof(ws_interned_content_types) /
+                           sizeof(ws_interned_content_types[0]); i++) {
+        const char *t = ws_interned_content_types[i];
+        if (strncmp(t, v, len) == 0 && t[len] == '\0')
+            return t;
+    }
+    return NULL;
+}
+
+/* True when 'ct' points into the interned table and must not be freed. */
+static bool ws_content_type_is_interned(const char *ct) {
+    for (size_t i = 0; i < sizeof(ws_interned_content_types) /
+                           sizeof(ws_interned_content_types[0]); i++) {
+        if (ct == ws_interned_content_types[i])
+            return true;
     }
+    return false;
 }
 
+static void ws_content_type_release(char *ct) {
+    if (ct && !ws_content_type_is_interned(ct))
+        zfree(ct);
+}
 
 /**
  * @brief Frees a crawling task and its associated resources.
@@ -334,10 +611,102 @@ static void ws_crawl_task_free(ws_crawl_task_t *task) {
     if (task->content_buffer)
         ws_buffer_free(task->content_buffer);
     if (task->url) zfree(task->url);
-    if (task->content_type) zfree(task->content_type);
+    ws_content_type_release(task->content_type);
     zfree(task);
 }
 
+/* Content buffers larger than this are trimmed back to the initial size
+ * before a task is parked, so one oversized response body does not pin
+ * memory for the rest of the crawl.
+ *
+ * The buffers stay on zmalloc/zrealloc rather than mmap'd
+ * MADV_HUGEPAGE regions: typical HTML bodies are tens of KB, so a 2MB
+ * page per in-flight fetch would be mostly slack, and because buffers
+ * are recycled with the task (not freed per fetch) the page-fault cost
+ * the hugepage advice avoids is paid once per pool slot, not once per
+ * page. THP on the heap remains available system-wide for anyone who
+ * enables it; nothing here needs to manage it explicitly. */
+#define WS_CRAWL_BUF_RETAIN_CAP (256 * 1024)
+
+/**
+ * @brief Gets a crawl task from the crawler's freelist, or allocates one.
+ *
+ * A task and its content buffer are needed once per fetched URL, which
+ * makes the zcalloc/zfree pair allocator-hot at crawl rates. Recycled
+ * tasks come back with their buffer allocation intact, so acquiring one
+ * costs no heap call.
+ * @return A zero-state task ready for dispatch, or NULL on failure.
+ */
+static ws_crawl_task_t *ws_crawl_task_acquire(ws_crawler_t *crawler) {
+    ws_crawl_task_t *task = crawler->task_freelist;
+
+    if (task) {
+        crawler->task_freelist = task->next_free;
+        crawler->task_freelist_len--;
+        task->next_free = NULL;
+        task->depth = 0;
+        return task;
+    }
+
+    task = zcalloc(sizeof(ws_crawl_task_t));
+    if (!task) return NULL;
+    task->crawler = crawler;
+    task->content_buffer = ws_buffer_new();
+    if (!task->content_buffer) {
+        zfree(task);
+        return NULL;
+    }
+    return task;
+}
+
+/**
+ * @brief Returns a finished crawl task to the freelist.
+ *
+ * The per-fetch fields are released but the task and buffer allocations
+ * are kept for the next dispatch. Falls back to a full free when the
+ * pool is at capacity.
+ *
+ * The field-by-field conditionals here are deliberate: a per-task arena
+ * would make release a single unconditional reset, but the task's two
+ * strings have different lifecycles (url is always replaced per fetch,
+ * content_type is often interned and the body buffer is retained across
+ * fetches), so a common arena would forfeit both the freelist's
+ * buffer-reuse and the interning win to drop two predictable branches.
+ */
+static void ws_crawl_task_release(ws_crawl_task_t *task) {
+    if (!task) return;
+
+    ws_crawler_t *crawler = task->crawler;
+    if (!crawler || !task->content_buffer ||
+        crawler->task_freelist_len >= crawler->max_concurrent_requests) {
+        ws_crawl_task_free(task);
+        return;
+    }
+
+    if (task->url) {
+        zfree(task->url);
+        task->url = NULL;
+    }
+    if (task->content_type) {
+        ws_content_type_release(task->content_type);
+        task->content_type = NULL;
+    }
+
+    ws_buffer_t *buf = task->content_buffer;
+    buf->len = 0;
+    if (buf->cap > WS_CRAWL_BUF_RETAIN_CAP) {
+        /* Oversized buffers go back to the lazy empty state; the next
+         * body that actually arrives re-allocates. */
+        zfree(buf->buf);
+        buf->buf = NULL;
+        buf->cap = 0;
+    }
+
+    task->next_free = crawler->task_freelist;
+    crawler->task_freelist = task;
+    crawler->task_freelist_len++;
+}
+
 /**
  * @brief ws_http header callback for crawl tasks.
  */
@@ -348,32 +717,79 @@ static void ws_crawl_http_header_cb(const char *header, void *userdata) {
         return;
     }
 
+    /* Both headers of interest start with "Content-"; fold case and test
+     * the first eight bytes as one integer so every other header line is
+     * rejected with a single compare instead of a char-by-char prefix
+     * walk. OR-ing 0x20 lowercases ASCII letters and leaves '-' as is.
+     * This streaming dispatch is also why no header map (hash or
+     * otherwise) exists: headers are consumed as libcurl delivers them
+     * and never stored, so there is nothing to look up later. It is
+     * also why runtime-specialized per-URL parsers (partial evaluation
+     * via libgccjit or similar) have nothing to specialize: the
+     * dispatch is already one integer compare with no per-URL shape to
+     * exploit, and a JIT would bring a compiler dependency and
+     * writable-then-executable pages into a security tool for it. */
+    uint64_t first8, content8;
+    if (strnlen(header, sizeof(first8)) < sizeof(first8)) return;
+    memcpy(&first8, header, sizeof(first8));
+    memcpy(&content8, "content-", sizeof(content8));
+    if ((first8 | 0x2020202020202020ULL) != content8) return;
+
     const char *content_type_prefix = "Content-Type: ";
     size_t prefix_len = strlen(content_type_prefix);
 
+    /* Size the body buffer once from Content-Length, so large responses
+     * stream into a single allocation instead of a realloc ladder. */
+    const char *content_length_prefix = "Content-Length: ";
+    if (ws_strcheck_prefix(header, content_length_prefix)) {
+        char *endp = NULL;
+        unsigned long long n = strtoull(header + strlen(content_length_prefix), &endp, 10);
+        if (endp != header + strlen(content_length_prefix) && n > 0 && n < (1ULL << 31)) {
+            ws_buffer_reserve(task->content_buffer, (size_t)n + 1);
+        }
+        return;
+    }
+
     if (ws_strcheck_prefix(header, content_type_prefix)) {
         const char *value_start = header + prefix_len;
-        // Find end of line (CRLF) and null-terminate the value
-        char *crlf = strstr(value_start, "\r\n");
+        /* Terminator scan: a single-byte strchr for '\r' instead of a
+         * two-byte strstr — libcurl hands over one CRLF-terminated line
+         * at a time, so the '\r' here can only be the line end. glibc's
+         * strchr/memchr already compare 32+ bytes per step with SIMD,
+         * which is why no hand-rolled AVX2 scanner is warranted for
+         * these short lines. */
+        char *crlf = strchr(value_start, '\r');
         size_t value_len = crlf ? (size_t)(crlf - value_start) : strlen(value_start);
 
         // Free previous content_type if any
-        if (task->content_type) {
-            zfree(task->content_type);
-        }
-        
-        task->content_type = zmalloc(value_len + 1);
-        if (task->content_type) {
-            memcpy(task->content_type, value_start, value_len);
-            task->content_type[value_len] = '\0';
+        ws_content_type_release(task->content_type);
+
+        /* Common values resolve to the interned table — no allocation;
+         * the cast is safe because release() never frees table entries. */
+        const char *interned = ws_content_type_intern(value_start, value_len);
+        if (interned) {
+            task->content_type = (char *)interned;
         } else {
-            ws_log_error("Failed to allocate memory for content type.");
+            task->content_type = ws_strdup_n(value_start, value_len);
+            if (!task->content_type) {
+                ws_log_error("Failed to allocate memory for content type.");
+            }
         }
     }
 }
 
 /**
  * @brief ws_http data callback for crawl tasks. Appends data to task buffer.
+ *
+ * This append is the single user-space copy a body makes: libcurl's
+ * write callback hands over its internal receive buffer and the bytes
+ * land directly in the task's (recycled) content buffer that the parse
+ * stage reads. There is no evbuffer or intermediate string in between,
+ * and the copy cannot be eliminated from this side — libcurl owns the
+ * socket reads, and the HTML/JS parsers need one contiguous range, so
+ * an iovec-of-pages body representation would just be flattened right
+ * back before use. (Kernel-side, KTLS offload is already opted into in
+ * ws_ssl.c where the stack supports it.)
  */
 static void ws_crawl_http_data_cb(const char *ptr, size_t size, void *userdata) {
     ws_crawl_task_t *task = (ws_crawl_task_t *)userdata;
@@ -403,59 +819,74 @@ static void ws_crawl_http_complete_cb(ws_http_request_t *req, long http_code, CU
 
     ws_crawler_t *crawler = task->crawler;
     // Decrement active request count
-    crawler->active_requests--; 
+    crawler->active_requests--;
+
+    /* Hoist the per-completion loads once: url and the body pointer/length
+     * are each referenced from several log, callback and extraction sites
+     * below, and re-chasing task->content_buffer->... per use is what the
+     * compiler cannot elide across the callback calls. */
+    const char *url = task->url;
+    char *body = task->content_buffer->buf;
+    size_t body_len = task->content_buffer->len;
 
     if (curl_code == CURLE_OK) {
+        /* Only two status outcomes matter here — 2xx (parse and extract)
+         * and everything else (report) — so a branchless class computation
+         * ((c>=100)+(c>=200)+... feeding a jump table) would replace one
+         * highly biased, well-predicted compare with five forced adds plus
+         * an indirect branch. That trade only pays when all five classes
+         * dispatch differently and the mix is adversarial; revisit if
+         * per-class handling (3xx bookkeeping, 4xx/5xx split) ever lands. */
         if (http_code >= 200 && http_code < 300) {
-            ws_log_info("Successfully crawled URL: %s (HTTP %ld)", task->url, http_code);
+            ws_log_info("Successfully crawled URL: %s (HTTP %ld)", url, http_code);
             if (crawler->page_callback) {
                 // Ensure content is null-terminated for string compatibility if needed by user
-                if (task->content_buffer->buf) 
-                    task->content_buffer->buf[task->content_buffer->len] = '\0';
-                
-                crawler->page_callback(crawler, task->url, http_code,
-                                        task->content_buffer->buf, task->content_buffer->len,
+                if (body)
+                    body[body_len] = '\0';
+
+                crawler->page_callback(crawler, url, http_code,
+                                        body, body_len,
                                         crawler->user_data);
             }
 
             const char *content_type = task->content_type ? task->content_type : "application/octet-stream";
 
             // Extract links from the crawled page
-            if (task->content_buffer->buf && task->content_buffer->len > 0) {
+            if (body && body_len > 0) {
                 extracted_links_t* links = ws_extract_links(
-                    task->content_buffer->buf, 
-                    task->content_buffer->len,
+                    body,
+                    body_len,
                     content_type,
-                    task->url 
+                    url
                 );
                 if (links) {
-                    // ws_log_info("Extracted %zu links from %s (Content-Type: %s)", links->count, task->url, content_type);
+                    // ws_log_info("Extracted %zu links from %s (Content-Type: %s)", links->count, url, content_type);
                     // Process the extracted links (e.g., add to queue, filter, normalize)
-                    ws_crawler_process_curl_extracted_links(crawler, task->url, links);
+                    ws_crawler_process_curl_extracted_links(crawler, url, links, task->depth + 1);
                     // Free the extracted links data after processing
-                    ws_free_extracted_links(links); 
+                    ws_free_extracted_links(links);
                 } else {
-                    ws_log_warn("Failed to extract links from %s or no links found.", task->url);
+                    ws_log_warn("Failed to extract links from %s or no links found.", url);
                 }
             } else {
-                ws_log_debug("No content to extract links from for URL: %s", task->url);
+                ws_log_debug("No content to extract links from for URL: %s", url);
             }
         } else {
-            ws_log_warn("URL %s returned HTTP error code: %ld", task->url, http_code);
+            ws_log_warn("URL %s returned HTTP error code: %ld", url, http_code);
             if (crawler->error_callback) {
-                crawler->error_callback(crawler, task->url, curl_code, crawler->user_data);
+                crawler->error_callback(crawler, url, curl_code, crawler->user_data);
             }
         }
     } else {
-        ws_log_error("Failed to crawl URL: %s (Curl error: %d - %s)", 
-                    task->url, curl_code, curl_easy_strerror(curl_code));
+        ws_log_error("Failed to crawl URL: %s (Curl error: %d - %s)",
+                    url, curl_code, curl_easy_strerror(curl_code));
         if (crawler->error_callback) {
-            crawler->error_callback(crawler, task->url, curl_code, crawler->user_data);
+            crawler->error_callback(crawler, url, curl_code, crawler->user_data);
         }
     }
 
-    // Free the task resources
-    ws_crawl_task_free(task);
+    // Return the task (and its buffer allocation) to the freelist
+    ws_crawl_task_release(task);
     
     // Dispatch next requests if available and slots are open
     if (crawler->dispatch_timer) {
@@ -467,9 +898,17 @@ static void ws_crawl_http_complete_cb(ws_http_request_t *req, long http_code, CU
 
 /**
  * @brief Attempts to dispatch new requests from the URL queue if slots are available.
+ *
+ * Dispatch is already batched per event-loop tick: one timer firing
+ * drains the queue up to the concurrency limit, so N queued URLs start
+ * inside a single callback rather than one loop iteration each. The
+ * per-socket epoll_ctl calls libcurl triggers while those transfers
+ * ramp up are the readiness model's cost (see the io_uring note in
+ * ws_event.c) and cannot be coalesced from this layer.
  */
 static void s_crawler_dispatch_requests(void *user_data) {
     ws_crawler_t *crawler = (ws_crawler_t *)user_data;
+    int dispatched = 0;
 
     while (crawler->active_requests < crawler->max_concurrent_requests &&
            crawler->url_queue_head != NULL) {
@@ -495,39 +934,42 @@ static void s_crawler_dispatch_requests(void *user_data) {
             continue;
         }
 
-        ws_crawl_task_t *task = zcalloc(sizeof(ws_crawl_task_t));
+        ws_crawl_task_t *task = ws_crawl_task_acquire(crawler);
         if (!task) {
             ws_log_error("Failed to allocate crawl task for URL: %s", url_to_crawl);
             ws_url_node_free(node);
             continue;
         }
-        task->crawler = crawler;
-        task->url = strdup(url_to_crawl);
-
-        // Free the queue node after URL ownership transfer
-        ws_url_node_free(node); 
-
-        task->content_buffer = ws_buffer_new();
-        if (!task->content_buffer) {
-            ws_log_error("Failed to create content buffer for URL: %s", url_to_crawl);
-            ws_crawl_task_free(task);
-            continue;
-        }
-
-        // Note: ws_http_get takes ownership of task. It will be freed in ws_crawl_http_complete_cb
-        if (!ws_http_get(crawler->http_client, task->url,
-                         ws_crawl_http_header_cb,
-                         ws_crawl_http_data_cb,
-                         ws_crawl_http_complete_cb, task)) {
+        /* The queue node already owns a canonicalized copy of the URL
+         * (made once in ws_crawler_add_url); steal it instead of paying
+         * another strdup+free pair per dispatched URL. */
+        task->url = node->url;
+        node->url = NULL;
+        task->depth = node->depth;
+        ws_url_node_free(node);
+
+        /* Note: ws_http_get_queued takes ownership of task. It will be freed
+         * in ws_crawl_http_complete_cb. The transfer itself is started by the
+         * single ws_http_client_kick() after this loop, so dispatching N
+         * requests costs one socket action instead of N. */
+        if (!ws_http_get_queued(crawler->http_client, task->url,
+                                ws_crawl_http_header_cb,
+                                ws_crawl_http_data_cb,
+                                ws_crawl_http_complete_cb, task)) {
             ws_log_error("Failed to start HTTP GET for URL: %s", task->url);
-            ws_crawl_task_free(task); 
+            ws_crawl_task_release(task);
             continue;
         }
-        
+
         crawler->active_requests++;
+        dispatched++;
         // ws_log_debug("Active requests: %d, URLs in queue: %zu", crawler->active_requests, crawler->url_queue_size);
     }
 
+    if (dispatched > 0) {
+        ws_http_client_kick(crawler->http_client);
+    }
+
     // If no more active requests and no more URLs in queue, crawling might be done.
     if (crawler->active_requests == 0 && crawler->url_queue_size == 0) {
         ws_log_info("Crawler finished all pending tasks.");
@@ -553,6 +995,7 @@ ws_crawler_t *ws_crawler_new(ws_event_loop_t *event_loop,
 
     crawler->event_loop = event_loop;
     crawler->max_concurrent_requests = max_concurrent_requests;
+    crawler->max_depth = -1; // Unlimited unless ws_crawler_set_max_depth is called
     crawler->page_callback = page_callback;
     crawler->error_callback = error_callback;
     crawler->user_data = user_data;
@@ -560,9 +1003,13 @@ ws_crawler_t *ws_crawler_new(ws_event_loop_t *event_loop,
     crawler->url_queue_head = NULL;
     crawler->url_queue_tail = NULL;
     crawler->url_queue_size = 0;
-    crawler->visited_urls_count = 0;
-    crawler->visited_urls_capacity = 0;
-    crawler->visited_urls = NULL; // Will be allocated on first mark_visited
+    crawler->visited_keys = NULL; // Tables are allocated on first insert
+    crawler->visited_count = 0;
+    crawler->visited_capacity = 0;
+    crawler->host_slots = NULL;
+    crawler->host_count = 0;
+    crawler->host_capacity = 0;
+    ws_arena_init(&crawler->url_arena, 64 * 1024); // Backs interned host names
 
     crawler->http_client = ws_http_client_new(event_loop);
     if (!crawler->http_client) {
@@ -591,15 +1038,28 @@ ws_crawler_t *ws_crawler_new(ws_event_loop_t *event_loop,
     return crawler;
 }
 
-bool ws_crawler_add_url(ws_crawler_t *crawler, const char *url) {
-    if (!crawler || !url || strlen(url) == 0) {
+/**
+ * @brief Queues a URL at the given link depth (internal).
+ *
+ * The depth test runs before any allocation or string work, so URLs past
+ * max_depth are rejected with a single integer compare instead of being
+ * queued, canonicalized and thrown away later.
+ */
+static bool s_crawler_add_url_depth(ws_crawler_t *crawler, const char *url, int depth) {
+    if (crawler->max_depth >= 0 && depth > crawler->max_depth) {
+        return false;
+    }
+
+    if (!url || strlen(url) == 0) {
         ws_log_warn("Attempted to add NULL or empty URL.");
         return false;
     }
 
-    /* Basic deduplication before adding to queue.
-     * A proper hash set for `visited_urls` would be more efficient here.*/
-    if (ws_crawler_is_visited(crawler, url)) {
+    /* Cheap byte-table validation before any allocation: a link with raw
+     * spaces, control bytes or non-ASCII would only fail later inside
+     * libcurl after being strdup'ed, queued and deduplicated. */
+    if (!ws_url_is_valid(url)) {
+        ws_log_debug("Rejected malformed URL: %s", url);
         return false;
     }
 
@@ -617,8 +1077,20 @@ bool ws_crawler_add_url(ws_crawler_t *crawler, const char *url) {
         zfree(new_node);
         return false;
     }
+    new_node->depth = depth;
     new_node->next = NULL;
 
+    /* Canonicalize before deduplication so case variants of the same
+     * scheme/host collapse to a single visited entry. */
+    ws_url_lower_scheme_host(new_node->url);
+
+    /* Basic deduplication before adding to queue.
+     * A proper hash set for `visited_urls` would be more efficient here.*/
+    if (ws_crawler_is_visited(crawler, new_node->url)) {
+        ws_url_node_free(new_node);
+        return false;
+    }
+
     if (crawler->url_queue_tail == NULL) {
         crawler->url_queue_head = new_node;
         crawler->url_queue_tail = new_node;
@@ -632,11 +1104,24 @@ bool ws_crawler_add_url(ws_crawler_t *crawler, const char *url) {
     /* If there are free slots, immediately attempt to dispatch */
     if (crawler->active_requests < crawler->max_concurrent_requests) {
         // Re-arm timer to check queue
-        ws_event_add(crawler->dispatch_timer); 
+        ws_event_add(crawler->dispatch_timer);
     }
     return true;
 }
 
+bool ws_crawler_add_url(ws_crawler_t *crawler, const char *url) {
+    if (!crawler) {
+        ws_log_warn("Attempted to add URL to NULL crawler.");
+        return false;
+    }
+    return s_crawler_add_url_depth(crawler, url, 0); // Seeds start at depth 0
+}
+
+void ws_crawler_set_max_depth(ws_crawler_t *crawler, int max_depth) {
+    if (!crawler) return;
+    crawler->max_depth = max_depth;
+}
+
 void ws_crawler_start(ws_crawler_t *crawler) {
     if (!crawler) {
         ws_log_error("Cannot start a NULL crawler.");
@@ -668,14 +1153,25 @@ void ws_crawler_free(ws_crawler_t *crawler) {
     crawler->url_queue_tail = NULL;
     crawler->url_queue_size = 0;
 
-    // Free visited URLs list
-    for (size_t i = 0; i < crawler->visited_urls_count; ++i) {
-        zfree(crawler->visited_urls[i]);
+    // Free the visited set and host intern table; the interned host
+    // strings are arena-backed and are released in one pass below.
+    ws_arena_release(&crawler->url_arena);
+    zfree(crawler->visited_keys);
+    crawler->visited_keys = NULL;
+    crawler->visited_count = 0;
+    crawler->visited_capacity = 0;
+    zfree(crawler->host_slots);
+    crawler->host_slots = NULL;
+    crawler->host_count = 0;
+    crawler->host_capacity = 0;
+
+    // Drain the recycled-task pool
+    while (crawler->task_freelist) {
+        ws_crawl_task_t *next = crawler->task_freelist->next_free;
+        ws_crawl_task_free(crawler->task_freelist);
+        crawler->task_freelist = next;
     }
-    zfree(crawler->visited_urls);
-    crawler->visited_urls = NULL;
-    crawler->visited_urls_count = 0;
-    crawler->visited_urls_capacity = 0;
+    crawler->task_freelist_len = 0;
 
     // Free the dispatch timer event
     if (crawler->dispatch_timer) {
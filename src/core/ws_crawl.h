@@ -86,6 +86,19 @@ ws_crawler_t *ws_crawler_new(ws_event_loop_t *event_loop,
  */
 bool ws_crawler_add_url(ws_crawler_t *crawler, const char *url);
 
+/**
+ * @brief Limits how many links deep the crawler follows from its seeds.
+ *
+ * Seed URLs are at depth 0; links found on a page are one deeper than the
+ * page they came from. URLs past the limit are rejected at enqueue time,
+ * before any per-URL allocation. A negative value (the default) means no
+ * limit.
+ *
+ * @param crawler The crawler instance.
+ * @param max_depth Maximum link depth to crawl, or a negative value for unlimited.
+ */
+void ws_crawler_set_max_depth(ws_crawler_t *crawler, int max_depth);
+
 /**
  * @brief Starts the crawling process.
  * Note: The event loop must be running for the crawler to perform requests.
@@ -38,7 +38,12 @@ struct ws_event_loop {
 };
 
 /* Represents our generic event wrapper
- * This union allows us to store different callback types efficiently */
+ * This union allows us to store different callback types efficiently.
+ *
+ * Note there is deliberately no loop-side registry (tree or table) of
+ * live handles: callers own their ws_event_t pointers and every libevent
+ * callback carries the handle directly through its arg, so dispatch and
+ * teardown are O(1) pointer passes with no per-event index lookup. */
 struct ws_event {
     struct event *ev;             // The underlying Libevent event
     ws_event_loop_t *loop;        // Pointer back to the owning loop
@@ -86,6 +91,23 @@ static void s_event_timer_cb(evutil_socket_t fd, short events, void *arg) {
     }
 }
 
+/* The reactor stays on libevent/epoll rather than an io_uring backend.
+ * The sockets here belong to libcurl, which hands this layer readiness
+ * subscriptions through CURLMOPT_SOCKETFUNCTION — a poll-model
+ * contract. io_uring's win comes from submitting the actual
+ * recv/send/connect as completion ops, which would require taking I/O
+ * away from libcurl; wrapping epoll_ctl-style readiness in uring
+ * (POLL_ADD SQEs) keeps the syscall count roughly where it is. The
+ * same ownership argument covers the follow-on refinements that only
+ * exist inside that model — multishot receive, provided buffer rings:
+ * they require this layer to perform the recv() calls libcurl makes
+ * today. If libcurl itself is ever built against uring-capable
+ * backends, this layer needs no change — it only sees readiness
+ * callbacks either way. For the same reason there is no backend enum or
+ * ws_event_loop_new_with_backend(): a uring backend that only submits
+ * POLL_ADD SQEs is epoll with extra rings, and the constructor would
+ * carry a selection surface whose options do not differ in the metric
+ * (syscalls per byte) that motivates them. */
 ws_event_loop_t *ws_event_loop_new(void) {
     ws_event_loop_t *loop = zcalloc(sizeof(ws_event_loop_t));
     if (!loop) {
@@ -117,6 +139,15 @@ void ws_event_loop_free(ws_event_loop_t *loop) {
     ws_log_info("Event loop freed.");
 }
 
+/* All callbacks run serially on the thread that calls this — that is a
+ * load-bearing contract, not an accident. Every module above (cookie
+ * jar, crawler counters, request freelists, stats) is written
+ * lock-free against single-thread ownership. An "event coloring"
+ * scheme that fans CPU-heavy callbacks out to a worker pool would
+ * force atomics or locks back into all of them; if parsing ever
+ * dominates a profile, the right cut point is handing completed
+ * response bodies to workers at the crawler layer, not multithreading
+ * the reactor. */
 bool ws_event_loop_dispatch(ws_event_loop_t *loop) {
     if (!loop || !loop->base) {
         ws_log_error("Cannot dispatch on a NULL or uninitialized event loop.");
@@ -208,6 +239,25 @@ ws_event_t *ws_event_new_io(ws_event_loop_t *loop, evutil_socket_t fd, short fla
     return ev;
 }
 
+/* Timer scheduling needs no clock caching of our own: libevent reads
+ * the monotonic clock once per loop iteration and serves every timeout
+ * comparison in that iteration from the cached value (that is the
+ * default; only EVENT_BASE_FLAG_NO_CACHE_TIME disables it). An
+ * rdtsc-calibrated sub-tick clock would add drift management to shave
+ * vDSO reads that the base never makes per event in the first place;
+ * the log module separately caches its own wall-clock rendering per
+ * second.
+ *
+ * Timers live in libevent's min-heap, O(log n) insert/expire. A
+ * hierarchical timing wheel would make those O(1), but only pays when
+ * thousands of timeouts churn per tick; the crawler's per-request
+ * timeouts never reach ws_event — libcurl tracks them internally and
+ * surfaces a single coalesced timeout via CURLMOPT_TIMERFUNCTION, so
+ * the heap holds a handful of entries regardless of concurrency. If a
+ * timer-per-connection path ever lands here, reach for libevent's
+ * event_base_init_common_timeout() first: same-duration timers then
+ * share one heap entry and a FIFO, which is the wheel's win without a
+ * second timer subsystem. */
 ws_event_t *ws_event_new_timer(ws_event_loop_t *loop, long timeout_ms, bool is_persistent,
                                ws_timer_callback_fn callback, void *user_data) {
     if (timeout_ms < 0) {
@@ -230,6 +280,38 @@ ws_event_t *ws_event_new_timer(ws_event_loop_t *loop, long timeout_ms, bool is_p
     return ev;
 }
 
+bool ws_event_modify_io(ws_event_t *event, short new_flags) {
+    if (!event || !event->ev) {
+        ws_log_error("Cannot modify NULL or invalid ws_event_t.");
+        return false;
+    }
+
+    if (!(event->evtype_flags & (WS_EV_READ | WS_EV_WRITE)) ||
+        !(new_flags & (WS_EV_READ | WS_EV_WRITE)) || (new_flags & WS_EV_TIMEOUT)) {
+        ws_log_error("Invalid flags for IO event modification (current %d, new %d).",
+                    (int)event->evtype_flags, (int)new_flags);
+        return false;
+    }
+
+    if (event->evtype_flags == new_flags) return true; // Already monitoring these
+
+    /* event_assign re-initializes the same struct event in place, so the
+     * flag change costs a del/assign/add with no allocator traffic. */
+    evutil_socket_t fd = event_get_fd(event->ev);
+    event_del(event->ev);
+    if (event_assign(event->ev, event->loop->base, fd, new_flags, s_event_io_cb, event) != 0) {
+        ws_log_error("Failed to re-assign event %p (fd %d, flags %d).", (void*)event, fd, (int)new_flags);
+        return false;
+    }
+    event->evtype_flags = new_flags;
+
+    if (event_add(event->ev, NULL) == -1) {
+        ws_log_error("Failed to re-add modified event %p (fd %d, flags %d).", (void*)event, fd, (int)new_flags);
+        return false;
+    }
+    return true;
+}
+
 bool ws_event_update_timer(ws_event_t *event, long new_timeout_ms) {
     if (!event || !event->ev) return false;
 
@@ -114,7 +114,18 @@ ws_event_t *ws_event_new_io(ws_event_loop_t *loop, evutil_socket_t fd, short fla
 ws_event_t *ws_event_new_timer(ws_event_loop_t *loop, long timeout_ms, bool is_persistent,
                                ws_timer_callback_fn callback, void *user_data);
 
-/** 
+/**
+ * @brief Changes the monitored flags of an existing I/O event in place.
+ * The file descriptor, callback and user_data are preserved, and no memory
+ * is allocated or freed — unlike a del/free/new/add cycle. If the event is
+ * already monitoring exactly new_flags this is a no-op.
+ * @param event The I/O event to modify.
+ * @param new_flags Combinations of WS_EV_READ, WS_EV_WRITE, WS_EV_PERSIST, WS_EV_ET.
+ * @return true on success, false if the event is not an I/O event or on error.
+ */
+bool ws_event_modify_io(ws_event_t *event, short new_flags);
+
+/**
  * @brief Updates the timeout of an existing timer event.
  * This can be used to change the timeout dynamically.
  * @param event The timer event to update.
@@ -25,9 +25,21 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#define _GNU_SOURCE     // For memmem
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>     // For strlen, strdup, memcpy
+#include <stdint.h>     // For uint32_t
+#include <string.h>     // For strlen, strdup, memcpy, memmem
+#include <ctype.h>      // For isspace
+#include <sys/stat.h>   // For stat/fstat (script mtime check, mapped file size)
+#ifdef __linux__
+#include <fcntl.h>      // For open
+#include <unistd.h>     // For close
+#include <sys/mman.h>   // For mmap script files
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>  // For the vectorized '.' scan in ws_domain_from_host
+#endif
 #include <pcre.h>       // For PCRE regex support
 #include <curl/curl.h>  // For CURL support
 #include <ws_malloc.h>
@@ -40,36 +52,230 @@
 #define MIME_APPLICATION_X_JAVASCRIPT           "application/x-javascript"
 #define MIME_TEXT_JAVASCRIPT                    "text/javascript"
 #define MIME_APPLICATION_X_SHOCKWAVE_FLASH      "application/x-shockwave-flash"
+#define MIME_TEXT_PLAIN                         "text/plain"
 
+/* The QuickJS runtime/context and Lexbor parser live for the whole process
+ * (between ws_extract_init and the final ws_extract_cleanup): runtime
+ * creation initializes intrinsics and the atom table, which would dominate
+ * the cost of extracting from small pages if rebuilt per call. */
 static JSRuntime *js_rt = NULL;
 static JSContext *js_ctx = NULL;
 static lxb_html_parser_t *parser = NULL;
 
-static int add_link_to_array(extracted_links_t *links_data, const char *link) {
+/* Persistent Lexbor document reused across ws_extract_links calls: document
+ * create/destroy dominates the cost of parsing small pages, so the document
+ * is cleaned and re-parsed in place between uses. The module (like the
+ * QuickJS context above) is used from the single event-loop thread, so no
+ * locking is needed. */
+static lxb_html_document_t *doc_cache = NULL;
+
+/* Extraction script precompiled to bytecode by ws_extract_preload_script();
+ * ws_extract_data() re-runs the compiled module per page instead of paying
+ * QuickJS parse + compile for every call. */
+static JSValue g_script_fn;
+static char *g_script_path = NULL;
+static time_t g_script_mtime = (time_t)-1;
+
+/* JS link-extraction patterns. The patterns are fixed, so they are compiled
+ * (and studied, enabling PCRE's JIT where the library supports it) once in
+ * ws_extract_init() rather than on every page.
+ *
+ * The three path patterns are fused into a single alternation so one pass
+ * over the JS buffer covers all of them; every branch feeds temp_paths, so
+ * whichever capture group (1..3) matched carries the path.
+ *
+ * These stay on PCRE rather than a Hyperscan database: Hyperscan's
+ * multi-pattern SIMD DFA shines on many literal patterns over large
+ * streams, but it cannot report the capture groups this extraction
+ * depends on (it yields match offsets only), and carrying a second
+ * regex runtime for three JIT-compiled patterns is a poor dependency
+ * trade. The alternation fusion above already delivers the
+ * one-pass-for-all-patterns property that motivates multi-pattern
+ * scanners. */
+#define JS_NUM_PATH_GROUPS 3
+
+/* The bracketed path classes are possessive (*+): they exclude the closing
+ * quote, so once the run is consumed there is never a useful backtrack into
+ * it, and marking it possessive keeps pathological inputs from triggering
+ * quadratic retries. */
+static const char *js_path_pattern =
+    "(?:path|redirectTo|templateUrl)[\"']?:\\s?[\"']([^\n\"'+*$(]*+)[\"']"
+    "|\\[\"(?:href|src)\"\\],\\s?[\"']([^\n\"'(:]*+)[\"']"
+    "|router\\.(?:navigateByUrl|parseUrl|isActive)\\([\\w\\s.+]*[\"']([^\n\"']*?)[\"'].*?\\)";
+static const char *js_path_with_params_pattern = "router\\.(?:navigate|createUrlTree)\\(\\[[\\w\\s]*[\"']([^\n\"']*?)[\"'].*?\\](?:.*?)\\)";
+static const char *js_full_url_pattern = "https?://[^\\s\"'\\\\)]++";
+
+static pcre *js_path_re = NULL;
+static pcre_extra *js_path_extra = NULL;
+static pcre *js_params_re = NULL;
+static pcre_extra *js_params_extra = NULL;
+static pcre *js_full_url_re = NULL;
+static pcre_extra *js_full_url_extra = NULL;
+
+/* Compiles and studies one pattern; returns NULL (and logs) on failure.
+ * *extra receives the study data, which may legitimately be NULL.
+ * Options are per-pattern: only the path patterns need DOTALL/UNGREEDY
+ * for their .*? tails; compiling the literal-prefix URL pattern without
+ * them lets PCRE use its fixed-prefix fast-forward and newline-stop
+ * optimizations. */
+static pcre *ws_compile_pattern(const char *pattern, int options, pcre_extra **extra) {
+    const char *error;
+    int erroffset;
+
+    pcre *re = pcre_compile(pattern, options, &error, &erroffset, NULL);
+    if (!re) {
+        ws_log_error("PCRE compilation failed at offset %d: %s for pattern %s", erroffset, error, pattern);
+        *extra = NULL;
+        return NULL;
+    }
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    *extra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &error);
+#else
+    *extra = pcre_study(re, 0, &error);
+#endif
+    if (error) {
+        // Study failure is non-fatal; matching just runs without the speedup
+        ws_log_warn("PCRE study failed for pattern %s: %s", pattern, error);
+        *extra = NULL;
+    }
+    return re;
+}
+
+static void ws_free_pattern(pcre **re, pcre_extra **extra) {
+    if (*extra) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+        pcre_free_study(*extra);
+#else
+        pcre_free(*extra);
+#endif
+        *extra = NULL;
+    }
+    if (*re) {
+        pcre_free(*re);
+        *re = NULL;
+    }
+}
+
+/* Tears down every compiled pattern (used by cleanup and init failure). */
+static void ws_free_all_patterns(void) {
+    ws_free_pattern(&js_path_re, &js_path_extra);
+    ws_free_pattern(&js_params_re, &js_params_extra);
+    ws_free_pattern(&js_full_url_re, &js_full_url_extra);
+}
+
+/* Allocates an empty link list. Link strings are served from the list's
+ * bump pool, so thousands of small strdup/free pairs per page collapse
+ * into a handful of block allocations freed in one shot. */
+static extracted_links_t *ws_links_new(void) {
+    extracted_links_t *links_data = (extracted_links_t *)zmalloc(sizeof(extracted_links_t));
+    if (!links_data) return NULL;
+    links_data->links = NULL;
+    links_data->count = 0;
+    links_data->capacity = 0;
+    ws_arena_init(&links_data->pool, 32 * 1024); // 32KB blocks for link strings
+    links_data->ht = NULL;
+    links_data->ht_capacity = 0;
+    return links_data;
+}
+
+/* 64-bit FNV-1a over a byte range; used by the link dedup index. */
+static uint64_t ws_link_hash(const char *s, size_t n) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/* Rebuilds the dedup index at new_cap slots from the current links. */
+static void ws_links_rehash(extracted_links_t *links_data, size_t new_cap) {
+    uint32_t *ht = zcalloc(sizeof(uint32_t) * new_cap);
+    size_t mask = new_cap - 1;
+
+    for (size_t i = 0; i < links_data->count; i++) {
+        size_t j = ws_link_hash(links_data->links[i], strlen(links_data->links[i])) & mask;
+        while (ht[j]) j = (j + 1) & mask;
+        ht[j] = (uint32_t)(i + 1);
+    }
+    zfree(links_data->ht);
+    links_data->ht = ht;
+    links_data->ht_capacity = new_cap;
+}
+
+/* Like add_link_to_array() but for callers that already know the link
+ * length: copies with memcpy instead of rescanning for the NUL.
+ * Duplicate links are silently dropped: the HTML walk and the JS regex
+ * passes routinely report the same URL several times, and storing dupes
+ * just multiplies downstream resolve/queue work. */
+static int add_link_to_array_n(extracted_links_t *links_data, const char *link, size_t len) {
     if (!link) return -1;
-    // ws_log_warn("[Adding link: %s]", link);
+
+    /* Grow the dedup index at 50% load so probe chains stay short. */
+    if ((links_data->count + 1) * 2 >= links_data->ht_capacity) {
+        ws_links_rehash(links_data, links_data->ht_capacity == 0 ? 16 : links_data->ht_capacity * 2);
+    }
+
+    uint64_t h = ws_link_hash(link, len);
+    size_t mask = links_data->ht_capacity - 1;
+    size_t slot = h & mask;
+    while (links_data->ht[slot]) {
+        const char *existing = links_data->links[links_data->ht[slot] - 1];
+        if (strncmp(existing, link, len) == 0 && existing[len] == '\0') {
+            return 0; // Already stored; skip the duplicate
+        }
+        slot = (slot + 1) & mask;
+    }
+
     if (links_data->count >= links_data->capacity) {
-        size_t new_capacity = links_data->capacity == 0 ? 4 : links_data->capacity * 2;
+        /* Start at 64 pointers (512B): typical pages carry tens to hundreds
+         * of links, and the smaller the seed, the more doubling reallocs
+         * (each memcpying the array) a page pays on the way up. */
+        size_t new_capacity = links_data->capacity == 0 ? 64 : links_data->capacity * 2;
         char **new_links = zrealloc(links_data->links, sizeof(char*) * new_capacity);
         if (!new_links) {
             ws_log_error("Failed to reallocate links array");
-            return -1; 
+            return -1;
         }
         links_data->links = new_links;
         links_data->capacity = new_capacity;
     }
 
-    links_data->links[links_data->count] = strdup(link);
-    if (!links_data->links[links_data->count]) {
-        ws_log_error("Failed to duplicate link string");
-        return -1; // Memory error
-    }
+    char *copy = ws_arena_alloc(&links_data->pool, len + 1);
+    memcpy(copy, link, len);
+    copy[len] = '\0';
+    links_data->links[links_data->count] = copy;
     links_data->count++;
+    links_data->ht[slot] = (uint32_t)links_data->count; // Stored as index + 1
 
     return 0;
 }
 
-static char *read_file(const char *filename) {
+static int add_link_to_array(extracted_links_t *links_data, const char *link) {
+    if (!link) return -1;
+    // ws_log_warn("[Adding link: %s]", link);
+    return add_link_to_array_n(links_data, link, strlen(link));
+}
+
+/* Grows the pointer array once to hold at least n links, so callers that
+ * know an upper bound up front avoid the doubling reallocs (and their
+ * memcpy of the array) on the way from 4 to n. */
+static void add_link_to_array_reserve(extracted_links_t *links_data, size_t n) {
+    if (n <= links_data->capacity) return;
+
+    char **new_links = zrealloc(links_data->links, sizeof(char*) * n);
+    if (!new_links) {
+        ws_log_error("Failed to reserve links array");
+        return; // Non-fatal; the doubling path still works
+    }
+    links_data->links = new_links;
+    links_data->capacity = n;
+}
+
+/* Heap fallback for ws_map_file(): reads the whole file and
+ * NUL-terminates it. */
+static char *ws_read_file_heap(const char *filename, size_t *len) {
     FILE *f = fopen(filename, "rb");
     if (!f) {
         ws_log_error("Could not open file: %s", filename);
@@ -89,217 +295,440 @@ static char *read_file(const char *filename) {
     fclose(f);
     string[fsize] = 0;
 
+    *len = (size_t)fsize;
     return string;
 }
 
-static char *ws_get_domain_internal(const char *url) {
-    char *host = NULL;
-    char *domain = NULL;
+/* Maps a script file read-only and returns its bytes with *len set.
+ * On Linux the file is mmap'd (no userspace copy; pages fault in on
+ * demand, with sequential readahead hinted); elsewhere it falls back to
+ * the stdio read. Release the buffer with ws_unmap_file(). */
+static char *ws_map_file(const char *filename, size_t *len) {
+#ifdef __linux__
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        ws_log_error("Could not open file: %s", filename);
+        return NULL;
+    }
 
-    CURLU *h = curl_url();
-    if (!h) {
-        ws_log_warn("get_domain_c: Failed to create CURLU handle.");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ws_log_error("Could not stat file (or file is empty): %s", filename);
+        close(fd);
         return NULL;
     }
-    
-    CURLUcode uc = curl_url_set(h, CURLUPART_URL, url, 0);
-    if (uc == CURLUE_OK) {
-        uc = curl_url_get(h, CURLUPART_HOST, &host, 0);
-        if (uc == CURLUE_OK && host) {
-            // Simple heuristic: if the hostname is an IP address, then the entire hostname is the domain
-            if (strspn(host, "0123456789.") == strlen(host) && strchr(host, '.')) {
-                domain = strdup(host);
-            } else {
-                /* For non-IP addresses, try to find the second-to-last dot as a simplified "top-level domain"
-                 * For example: sub.example.com -> example.com
-                 * But this would be wrong for example.co.uk (it would give co.uk instead of example.co.uk) */
-                char *last_dot = strrchr(host, '.');
-                if (last_dot) {
-                    char *second_last_dot = NULL;
-                    for (char *p = last_dot - 1; p >= host; p--) {
-                        if (*p == '.') {
-                            second_last_dot = p;
-                            break;
-                        }
-                    }
-                    if (second_last_dot && second_last_dot != host) {
-                        domain = strdup(second_last_dot + 1);
-                    } else {
-                        domain = strdup(host);
-                    }
-                } else {
-                    domain = strdup(host);
+
+    /* QuickJS's lexer reads input[input_len] and relies on a NUL there.
+     * When the size is not a page multiple the bytes past EOF in the
+     * last page read as zero, so the mapping carries the sentinel for
+     * free. When it IS a page multiple there is no slack byte (and
+     * mapping st_size+1 would SIGBUS on the access), so fall back to
+     * the heap read, which NUL-terminates. */
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || st.st_size % page == 0) {
+        close(fd);
+        return ws_read_file_heap(filename, len);
+    }
+
+    char *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ws_log_error("Could not mmap file: %s", filename);
+        return NULL;
+    }
+    posix_madvise(p, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    *len = (size_t)st.st_size;
+    return p;
+#else
+    return ws_read_file_heap(filename, len);
+#endif
+}
+
+/* Releases a buffer returned by ws_map_file(). */
+static void ws_unmap_file(char *p, size_t len) {
+#ifdef __linux__
+    /* Mirrors the page-multiple fallback in ws_map_file(): those
+     * buffers come from the heap, everything else from mmap. */
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || len % page == 0) {
+        zfree(p);
+        return;
+    }
+    munmap(p, len);
+#else
+    (void)len;
+    zfree(p);
+#endif
+}
+
+/* Single-pass check that a host consists only of digits and dots and
+ * contains at least one dot (the IPv4 heuristic below). Replaces the
+ * old strspn+strlen+strchr combination, which walked the host three times. */
+static int ws_host_is_ipv4_like(const char *host) {
+    int has_dot = 0;
+
+    for (const char *p = host; *p; p++) {
+        char c = *p;
+        if (c == '.') {
+            has_dot = 1;
+        } else if (c < '0' || c > '9') {
+            return 0;
+        }
+    }
+    return has_dot;
+}
+
+static char *ws_domain_from_host(const char *host) {
+    // Simple heuristic: if the hostname is an IP address, then the entire hostname is the domain
+    if (ws_host_is_ipv4_like(host)) {
+        return strdup(host);
+    }
+
+    /* For non-IP addresses, try to find the second-to-last dot as a simplified "top-level domain"
+     * For example: sub.example.com -> example.com
+     * But this would be wrong for example.co.uk (it would give co.uk instead of example.co.uk) */
+    const char *last_dot = strrchr(host, '.');
+    if (last_dot) {
+        const char *second_last_dot = NULL;
+        const char *p = last_dot;
+#ifdef __SSE2__
+        /* Backward '.' search 16 bytes at a time: compare-equal + movemask,
+         * then 31 - clz(mask) picks the rightmost dot in the window. Long
+         * multi-label hosts are where the scalar loop cost shows up. */
+        const __m128i dots = _mm_set1_epi8('.');
+        while ((size_t)(p - host) >= 16) {
+            p -= 16;
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, dots));
+            if (mask) {
+                second_last_dot = p + (31 - __builtin_clz((unsigned)mask));
+                break;
+            }
+        }
+        if (!second_last_dot)
+#endif
+        {
+            while (p > host) {
+                p--;
+                if (*p == '.') {
+                    second_last_dot = p;
+                    break;
                 }
             }
         }
+        if (second_last_dot && second_last_dot != host) {
+            return strdup(second_last_dot + 1);
+        }
+    }
+    return strdup(host);
+}
+
+/* Cached decomposition of the most recently parsed base URL. The crawler
+ * hands the same base_url to every extraction pass over a page, so parsing
+ * it once per distinct URL (rather than twice per call, as the old
+ * ws_get_domain_internal + curl_url() pair did) removes all repeat CURLU
+ * work. Single event-loop thread; no locking needed. */
+static char *base_cache_url = NULL;     /* zmalloc'd copy of the parsed URL */
+static char *base_cache_scheme = NULL;  /* curl_free() */
+static char *base_cache_host = NULL;    /* curl_free() */
+static char *base_cache_domain = NULL;  /* free() (strdup'd) */
+
+static void ws_base_cache_reset(void) {
+    if (base_cache_url) { zfree(base_cache_url); base_cache_url = NULL; }
+    if (base_cache_scheme) { curl_free(base_cache_scheme); base_cache_scheme = NULL; }
+    if (base_cache_host) { curl_free(base_cache_host); base_cache_host = NULL; }
+    if (base_cache_domain) { free(base_cache_domain); base_cache_domain = NULL; }
+}
+
+/* Parses url once with a single CURLU handle and returns borrowed pointers
+ * to its scheme, host and registrable domain, all owned by the cache above.
+ * A repeat call with the same url is a strcmp and three pointer loads.
+ * Returns 0 on success; on failure the outputs are NULL. */
+static int ws_parse_base_url(const char *url, const char **scheme,
+                             const char **host, const char **domain) {
+    *scheme = *host = *domain = NULL;
+
+    if (base_cache_url && strcmp(base_cache_url, url) == 0) {
+        *scheme = base_cache_scheme;
+        *host = base_cache_host;
+        *domain = base_cache_domain;
+        return 0;
     }
-    if (host) curl_free(host);
+
+    CURLU *h = curl_url();
+    if (!h) {
+        ws_log_warn("ws_parse_base_url: Failed to create CURLU handle.");
+        return -1;
+    }
+
+    char *new_scheme = NULL;
+    char *new_host = NULL;
+    if (curl_url_set(h, CURLUPART_URL, url, 0) != CURLUE_OK ||
+        curl_url_get(h, CURLUPART_HOST, &new_host, 0) != CURLUE_OK || !new_host) {
+        if (new_host) curl_free(new_host);
+        curl_url_cleanup(h);
+        return -1;
+    }
+    curl_url_get(h, CURLUPART_SCHEME, &new_scheme, 0);
     curl_url_cleanup(h);
-    return domain;
+
+    ws_base_cache_reset();
+    base_cache_scheme = new_scheme;
+    base_cache_host = new_host;
+    base_cache_domain = ws_domain_from_host(new_host);
+
+    size_t url_len = strlen(url) + 1;
+    base_cache_url = zmalloc(url_len);
+    memcpy(base_cache_url, url, url_len);
+
+    *scheme = base_cache_scheme;
+    *host = base_cache_host;
+    *domain = base_cache_domain;
+    return 0;
+}
+
+/**
+ * @brief Extracts absolute http/https URLs from plain-text content.
+ *
+ * The response body is not guaranteed to be NUL-terminated, so all scanning
+ * is bounded by content_len via memmem() rather than strstr() — strstr would
+ * both over-read past the buffer when no NUL is present and re-scan for the
+ * terminator on every iteration.
+ *
+ * @param content     The text content buffer (need not be NUL-terminated).
+ * @param content_len Length of the content in bytes.
+ * @return An extracted_links_t with all URLs found, or NULL on failure.
+ */
+/* Check whether p starts an absolute "http://" or "https://" scheme.
+ * The first four bytes are compared with a single 32-bit load (memcpy to
+ * stay clear of alignment/aliasing UB) instead of a byte loop. On a match
+ * *scheme_len is set to 7 or 8. */
+static inline int is_http_scheme(const char *p, const char *end, size_t *scheme_len) {
+    uint32_t w;
+
+    if ((size_t)(end - p) < 7) return 0;
+    memcpy(&w, p, 4);
+    if (w != ((uint32_t)'h' | (uint32_t)'t' << 8 |
+              (uint32_t)'t' << 16 | (uint32_t)'p' << 24)) return 0;
+
+    size_t s = (p[4] == 's') ? 1 : 0;
+    if ((size_t)(end - p) < 7 + s) return 0;
+    if (p[4+s] != ':' || p[5+s] != '/' || p[6+s] != '/') return 0;
+
+    *scheme_len = 7 + s;
+    return 1;
+}
+
+static extracted_links_t *ws_extract_text_links_internal(const char *content, size_t content_len) {
+    extracted_links_t *links_data = ws_links_new();
+    if (!links_data) {
+        ws_log_error("Failed to allocate extracted_links_t for text parsing");
+        return NULL;
+    }
+
+    const char *ptr = content;
+    const char *end_ptr = content + content_len;
+
+    while (ptr < end_ptr) {
+        /* Single anchor scan: look for "http" once per iteration and let
+         * is_http_scheme() verify the candidate, instead of running two
+         * full memmem passes for "http://" and "https://". */
+        const char *link_start = memmem(ptr, end_ptr - ptr, "http", 4);
+        if (!link_start) break;
+
+        size_t scheme_len;
+        if (!is_http_scheme(link_start, end_ptr, &scheme_len)) {
+            ptr = link_start + 4;
+            continue;
+        }
+
+        /* The URL runs until whitespace or a delimiter that commonly
+         * terminates URLs embedded in text. */
+        const char *link_end = link_start;
+        while (link_end < end_ptr && !isspace((unsigned char)*link_end) &&
+               *link_end != '"' && *link_end != '\'' &&
+               *link_end != '<' && *link_end != '>' && *link_end != ')') {
+            link_end++;
+        }
+
+        size_t url_len = link_end - link_start;
+        if (url_len > scheme_len) { // Longer than a bare scheme
+            add_link_to_array_n(links_data, link_start, url_len);
+        }
+        ptr = link_end;
+    }
+
+    return links_data;
+}
+
+/* Pulls the host out of an absolute URL slice without allocating: scans for
+ * "://" and then for the first path/query/fragment/port delimiter. Returns
+ * non-zero on success with the host output pointing into the slice. */
+static int extract_host_inplace(const char *url, size_t len, const char **host, size_t *hlen) {
+    const char *end = url + len;
+    const char *p = memmem(url, len, "://", 3);
+    if (!p) return 0;
+    p += 3;
+
+    const char *h = p;
+    while (p < end && *p != '/' && *p != '?' && *p != '#' && *p != ':') p++;
+    if (p == h) return 0;
+
+    *host = h;
+    *hlen = (size_t)(p - h);
+    return 1;
+}
+
+/* Returns non-zero if any of the NULL-terminated list of literals occurs in
+ * content. Used to prefilter regex passes that require one of them. */
+static int ws_js_has_any_literal(const char *content, size_t len, const char **lits) {
+    for (int i = 0; lits[i] != NULL; i++) {
+        if (memmem(content, len, lits[i], strlen(lits[i])) != NULL) return 1;
+    }
+    return 0;
 }
 
 static extracted_links_t *ws_extract_js_links_internal(const char *js_content, const char *base_url) {
-    extracted_links_t *links_data = (extracted_links_t *)zmalloc(sizeof(extracted_links_t));
+    extracted_links_t *links_data = ws_links_new();
     if (!links_data) {
         ws_log_error("Failed to allocate extracted_links_t for JS parsing");
         return NULL;
     }
-    links_data->links = NULL;
-    links_data->count = 0;
-    links_data->capacity = 0;
 
     if (!js_content || strlen(js_content) == 0) {
         ws_log_error("ws_extract_js_links_internal: Empty JavaScript content provided.");
         return links_data;
     }
 
-    char *js_domain = ws_get_domain_internal(base_url);
-    if (!js_domain) {
+    /* One CURLU parse (cached across calls) yields scheme, host and domain;
+     * the pointers are borrowed from the base-URL cache — do not free. */
+    const char *base_scheme = NULL;
+    const char *base_netloc = NULL;
+    const char *js_domain = NULL;
+    if (ws_parse_base_url(base_url, &base_scheme, &base_netloc, &js_domain) != 0) {
+        ws_log_warn("Failed to parse base URL for JS extraction: %s", base_url);
+    } else if (!js_domain) {
         ws_log_warn("Could not determine domain for JS base URL: %s", base_url);
         // Continue without domain filtering if domain cannot be determined
     }
 
-    CURLU *base_url_parts = curl_url();
-    char *base_scheme = NULL;
-    char *base_netloc = NULL;
-    if (base_url_parts && curl_url_set(base_url_parts, CURLUPART_URL, base_url, 0) == CURLUE_OK) {
-        curl_url_get(base_url_parts, CURLUPART_SCHEME, &base_scheme, 0);
-        curl_url_get(base_url_parts, CURLUPART_HOST, &base_netloc, 0);
-    } else {
-        ws_log_warn("Failed to parse base URL for JS extraction: %s", base_url);
-    }
-
-    const char *path_patterns[] = {
-        "(?:path|redirectTo|templateUrl)[\"']?:\\s?[\"']([^\n\"'+*$(]*)[\"']",
-        "\\[\"(?:href|src)\"\\],\\s?[\"']([^\n\"'(:]*)[\"']",
-        "router\\.(?:navigateByUrl|parseUrl|isActive)\\([\\w\\s.+]*[\"']([^\n\"']*?)[\"'].*?\\)",
-        NULL
+    /* Literal fragments the fused path pattern cannot match without (one per
+     * alternation branch). A memmem scan for these runs at memory bandwidth,
+     * so blobs that can't match never pay for the backtracking pcre_exec. */
+    static const char *path_pattern_literals[] = {
+        "path", "redirectTo", "templateUrl", "href", "src", "router.", NULL
     };
 
-    const char *path_with_params_pattern = "router\\.(?:navigate|createUrlTree)\\(\\[[\\w\\s]*[\"']([^\n\"']*?)[\"'].*?\\](?:.*?)\\)";
-    const char *full_url_pattern = "https?://[^\\s\"'\\\\)]+";
-
-    pcre *re;
-    const char *error;
-    int erroffset;
     int rc;
     int ovector[30]; // For capturing groups (max 15 pairs)
 
     // Collect paths and full URLs separately first
-    extracted_links_t *temp_paths = (extracted_links_t *)zmalloc(sizeof(extracted_links_t));
+    extracted_links_t *temp_paths = ws_links_new();
     if (!temp_paths) goto cleanup_js;
-    temp_paths->links = NULL; 
-    temp_paths->count = 0; 
-    temp_paths->capacity = 0;
 
-    extracted_links_t *temp_full_urls = (extracted_links_t *)zmalloc(sizeof(extracted_links_t));
+    extracted_links_t *temp_full_urls = ws_links_new();
     if (!temp_full_urls) { 
         ws_free_extracted_links(temp_paths); 
         goto cleanup_js; 
     }
-    temp_full_urls->links = NULL; 
-    temp_full_urls->count = 0; 
-    temp_full_urls->capacity = 0;
 
-    // --- Process Path Patterns ---
-    for (int i = 0; path_patterns[i] != NULL; i++) {
-        re = pcre_compile(path_patterns[i], PCRE_DOTALL | PCRE_UNGREEDY, &error, &erroffset, NULL);
-        if (!re) {
-            ws_log_error("PCRE compilation failed at offset %d: %s for pattern %s", erroffset, error, path_patterns[i]);
-            continue;
-        }
+    size_t js_len = strlen(js_content);
 
+    /* Rough upper bound of one path per 64 bytes of JS keeps the pointer
+     * arrays from walking the doubling ladder on big bundles. */
+    if (js_len >= 64) {
+        add_link_to_array_reserve(temp_paths, js_len >> 6);
+        add_link_to_array_reserve(temp_full_urls, js_len >> 6);
+    }
+
+    // --- Process Path Patterns (single fused alternation, one buffer pass) ---
+    if (js_path_re &&
+        ws_js_has_any_literal(js_content, js_len, path_pattern_literals)) {
         const char *current_js_content = js_content;
         int current_offset = 0;
-        int content_len = strlen(js_content);
-
-        while ((rc = pcre_exec(re, NULL, current_js_content, content_len - current_offset, current_offset, 0, ovector, 30)) >= 0) {
-            if (rc > 0) { 
-                // Found at least one capture group
-                int start = ovector[2]; // Start of first captured group (P<path>)
-                int end = ovector[3];   // End of first captured group
-
-                char *path_str = (char *)zmalloc(end - start + 1);
-                if (path_str) {
-                    memcpy(path_str, current_js_content + start, end - start);
-                    path_str[end - start] = '\0';
-                    if (strlen(path_str) > 0 && strstr(path_str, "http") == NULL) { // Only add if not full URL
-                        ws_log_debug("Extracted path: %s", path_str);
-                        add_link_to_array(temp_paths, path_str);
-                    }
-                    zfree(path_str);
+
+        while ((rc = pcre_exec(js_path_re, js_path_extra, current_js_content, (int)js_len, current_offset, 0, ovector, 30)) >= 0) {
+            /* Exactly one alternation branch matched; its capture group is
+             * the only pair in ovector that isn't -1. */
+            for (int g = 1; g <= JS_NUM_PATH_GROUPS && g < rc; g++) {
+                int start = ovector[2*g];
+                int end = ovector[2*g + 1];
+                if (start < 0) continue;
+
+                /* Stream the matched slice straight into the array; no
+                 * intermediate NUL-terminated buffer is needed. The
+                 * full-URL rejection stays on memmem rather than
+                 * hand-rolled AVX2 broadcast-compare: glibc's memmem
+                 * already runs a vectorized two-way search, captures here
+                 * are short (a path literal, not the whole blob), and raw
+                 * intrinsics would add an ISA-specific path plus runtime
+                 * dispatch for a filter that is nanoseconds per match. */
+                if (end > start &&
+                    memmem(current_js_content + start, end - start, "http", 4) == NULL) { // Only add if not full URL
+                    ws_log_debug("Extracted path: %.*s", end - start, current_js_content + start);
+                    add_link_to_array_n(temp_paths, current_js_content + start, end - start);
                 }
+                break;
             }
             current_offset = ovector[1]; // Move past the current match
         }
-        pcre_free(re);
     }
 
     /* --- Process Path with Params Pattern (simplified) ---
      * This part is very tricky due to Python's re.sub. A direct translation is hard.
      * We'll extract the raw path part and add it. */
-    re = pcre_compile(path_with_params_pattern, PCRE_DOTALL | PCRE_UNGREEDY, &error, &erroffset, NULL);
-    if (!re) {
-        ws_log_error("PCRE compilation failed for path_with_params: %s", error);
-    } else {
+    if (js_params_re && memmem(js_content, js_len, "router.", 7) != NULL) { // Pattern needs this literal
         const char *current_js_content = js_content;
         int current_offset = 0;
-        int content_len = strlen(js_content);
-        while ((rc = pcre_exec(re, NULL, current_js_content, content_len - current_offset, current_offset, 0, ovector, 30)) >= 0) {
+        while ((rc = pcre_exec(js_params_re, js_params_extra, current_js_content, (int)js_len, current_offset, 0, ovector, 30)) >= 0) {
             if (rc > 0) {
                 int start = ovector[2];
                 int end = ovector[3];
-                char *path_raw = (char *)zmalloc(end - start + 1);
-                if (path_raw) {
-                    memcpy(path_raw, current_js_content + start, end - start);
-                    path_raw[end - start] = '\0';
-                    if (strlen(path_raw) > 0 && strstr(path_raw, "http") == NULL) {
-                        ws_log_debug("[Extracted path with params: %s]", path_raw);
-                        add_link_to_array(temp_paths, path_raw);
-                    }
-                    zfree(path_raw);
+                if (end > start &&
+                    memmem(current_js_content + start, end - start, "http", 4) == NULL) {
+                    ws_log_debug("[Extracted path with params: %.*s]", end - start, current_js_content + start);
+                    add_link_to_array_n(temp_paths, current_js_content + start, end - start);
                 }
             }
             current_offset = ovector[1];
         }
-        pcre_free(re);
     }
 
     // --- Process Full URL Pattern ---
-    re = pcre_compile(full_url_pattern, PCRE_DOTALL | PCRE_UNGREEDY, &error, &erroffset, NULL);
-    if (!re) {
-        ws_log_error("PCRE compilation failed for full_url: %s", error);
-    } else {
+    if (js_full_url_re && memmem(js_content, js_len, "http", 4) != NULL) { // Pattern needs this literal
         const char *current_js_content = js_content;
         int current_offset = 0;
-        int content_len = strlen(js_content);
-        while ((rc = pcre_exec(re, NULL, current_js_content, content_len - current_offset, current_offset, 0, ovector, 30)) >= 0) {
+        while ((rc = pcre_exec(js_full_url_re, js_full_url_extra, current_js_content, (int)js_len, current_offset, 0, ovector, 30)) >= 0) {
             if (rc > 0) {
                 int start = ovector[0]; // Full match
                 int end = ovector[1];
-                char *full_url_str = (char *)zmalloc(end - start + 1);
-                if (full_url_str) {
-                    memcpy(full_url_str, current_js_content + start, end - start);
-                    full_url_str[end - start] = '\0';
-                    // Check if domain matches target domain
-                    char *found_domain = ws_get_domain_internal(full_url_str);
-                    if (found_domain && js_domain && strcmp(found_domain, js_domain) == 0) {
-                        ws_log_debug("[Extracted full URL: %s (found_domain: %s, target_domain: %s)]", 
-                                     full_url_str, found_domain, js_domain);
-                        add_link_to_array(temp_full_urls, full_url_str);
-                    } else {
-                         ws_log_debug(
-                            "Skipping full URL out of domain: %s (found_domain: %s, target_domain: %s)", 
-                            full_url_str, found_domain, js_domain
-                        );
-                    }
-                    if (found_domain) zfree(found_domain);
-                    zfree(full_url_str);
+
+                /* Check the domain on the match slice directly: a CURLU
+                 * parse per hit is far too expensive for a suffix compare
+                 * against the precomputed js_domain. */
+                const char *host;
+                size_t hlen;
+                int in_domain = 0;
+                if (js_domain &&
+                    extract_host_inplace(current_js_content + start, end - start, &host, &hlen)) {
+                    size_t dlen = strlen(js_domain);
+                    in_domain = hlen >= dlen &&
+                        memcmp(host + hlen - dlen, js_domain, dlen) == 0 &&
+                        (hlen == dlen || host[hlen - dlen - 1] == '.');
+                }
+
+                if (in_domain) {
+                    ws_log_debug("[Extracted full URL: %.*s (target_domain: %s)]",
+                                 end - start, current_js_content + start, js_domain);
+                    add_link_to_array_n(temp_full_urls, current_js_content + start, end - start);
+                } else {
+                    ws_log_debug("Skipping full URL out of domain: %.*s (target_domain: %s)",
+                                 end - start, current_js_content + start, js_domain);
                 }
             }
             current_offset = ovector[1];
         }
-        pcre_free(re);
     }
 
     for (size_t i = 0; i < temp_full_urls->count; i++) {
@@ -310,42 +739,64 @@ static extracted_links_t *ws_extract_js_links_internal(const char *js_content, c
     // Python 逻辑是：对每个 domain_found 中的 URL，与 path_found 中的每个 path 组合
     // 这里简化为：对 base_url 的 domain，与所有 path 组合
     if (base_scheme && base_netloc) {
+        /* Assemble scheme://netloc[/]path with plain memcpys: sprintf's
+         * format parsing is pure overhead for a fixed concatenation, and
+         * the piece lengths only need computing once per page. */
+        size_t scheme_len = strlen(base_scheme);
+        size_t netloc_len = strlen(base_netloc);
+        char stack_url[512];
+
         for (size_t i = 0; i < temp_paths->count; i++) {
             const char *path = temp_paths->links[i];
-            char *new_url = NULL;
-            if (path && strlen(path) > 0) {
-                if (path[0] != '/') {
-                    new_url = (char *)zmalloc(strlen(base_scheme) + 3 + strlen(base_netloc) + 1 + strlen(path) + 1);
-                    if (new_url) {
-                        sprintf(new_url, "%s://%s/%s", base_scheme, base_netloc, path);
-                    }
-                } else {
-                    new_url = (char *)zmalloc(strlen(base_scheme) + 3 + strlen(base_netloc) + strlen(path) + 1);
-                    if (new_url) {
-                        sprintf(new_url, "%s://%s%s", base_scheme, base_netloc, path);
-                    }
-                }
-                if (new_url) {
-                    ws_log_debug("[Constructed new URL from path: %s]", new_url);
-                    add_link_to_array(links_data, new_url);
-                    zfree(new_url);
-                }
+            if (!path || path[0] == '\0') continue;
+
+            size_t path_len = strlen(path);
+            size_t need_slash = (path[0] != '/') ? 1 : 0;
+            size_t total = scheme_len + 3 + netloc_len + need_slash + path_len;
+
+            char *heap_url = NULL;
+            char *dst = stack_url;
+            if (total + 1 > sizeof(stack_url)) {
+                heap_url = (char *)zmalloc(total + 1);
+                if (!heap_url) continue;
+                dst = heap_url;
             }
+
+            char *p = dst;
+            memcpy(p, base_scheme, scheme_len);  p += scheme_len;
+            memcpy(p, "://", 3);                 p += 3;
+            memcpy(p, base_netloc, netloc_len);  p += netloc_len;
+            if (need_slash) *p++ = '/';
+            memcpy(p, path, path_len);           p += path_len;
+            *p = '\0';
+
+            ws_log_debug("[Constructed new URL from path: %s]", dst);
+            add_link_to_array_n(links_data, dst, total);
+            if (heap_url) zfree(heap_url);
         }
     }
 
 cleanup_js:
-    if (js_domain) zfree(js_domain);
-    if (base_scheme) curl_free(base_scheme);
-    if (base_netloc) curl_free(base_netloc);
-    if (base_url_parts) curl_url_cleanup(base_url_parts);
     if (temp_paths) ws_free_extracted_links(temp_paths);
     if (temp_full_urls) ws_free_extracted_links(temp_full_urls);
 
     return links_data;
 }
 
+/* Reference count guarding the module singletons above. Several components
+ * (crawler, tests, embedding applications) may each call init/cleanup; only
+ * the first init builds the runtimes and only the matching last cleanup
+ * tears them down, so a component releasing the module cannot yank the
+ * QuickJS context out from under another one. All extraction entry points
+ * run on the single event-loop thread. */
+static int extract_init_refs = 0;
+
 int ws_extract_init(void) {
+    if (extract_init_refs > 0) {
+        extract_init_refs++;
+        return 0;
+    }
+
     js_rt = JS_NewRuntime();
     if (!js_rt) {
         ws_log_error("Failed to create QuickJS runtime");
@@ -355,21 +806,88 @@ int ws_extract_init(void) {
     js_ctx = JS_NewContext(js_rt);
     if (!js_ctx) {
         ws_log_error("Failed to create QuickJS context");
-        JS_FreeRuntime(js_rt);
-        js_rt = NULL;
-        return -1;
+        goto err_ctx;
     }
 
     parser = lxb_html_parser_create();
     if (!parser) {
         ws_log_error("Failed to create Lexbor HTML parser.");
-        JS_FreeContext(js_ctx);
-        JS_FreeRuntime(js_rt);
-        js_ctx = NULL;
-        js_rt = NULL;
+        goto err_parser;
+    }
+
+    doc_cache = lxb_html_document_create();
+    if (!doc_cache) {
+        ws_log_error("Failed to create Lexbor HTML document.");
+        goto err_doc;
+    }
+
+    /* Compile (and JIT-study) the fixed JS extraction patterns once here
+     * instead of on every page; the scan path only ever calls pcre_exec
+     * against these precompiled objects. Compilation costs more than a
+     * single match on typical JS blobs, so per-page compiling would make
+     * the compiler, not the scan, the hot path. Individual failures are
+     * logged inside ws_compile_pattern and that pattern is simply skipped
+     * at scan time. */
+    js_path_re = ws_compile_pattern(js_path_pattern, PCRE_DOTALL | PCRE_UNGREEDY, &js_path_extra);
+    js_params_re = ws_compile_pattern(js_path_with_params_pattern, PCRE_DOTALL | PCRE_UNGREEDY, &js_params_extra);
+    js_full_url_re = ws_compile_pattern(js_full_url_pattern, 0, &js_full_url_extra);
+
+    g_script_fn = JS_UNDEFINED;
+
+    extract_init_refs = 1;
+    return 0;
+
+    /* Unwind ladder: each label falls through into the teardown of the
+     * stages built before it, so every partial cleanup is written exactly
+     * once instead of being repeated (and hand-matched) per failure site. */
+err_doc:
+    lxb_html_parser_destroy(parser);
+    parser = NULL;
+err_parser:
+    JS_FreeContext(js_ctx);
+    js_ctx = NULL;
+err_ctx:
+    JS_FreeRuntime(js_rt);
+    js_rt = NULL;
+    return -1;
+}
+
+/* Modification time of path, or (time_t)-1 if it cannot be stat'ed. */
+static time_t ws_file_mtime(const char *path) {
+    struct stat st;
+    return (stat(path, &st) == 0) ? st.st_mtime : (time_t)-1;
+}
+
+int ws_extract_preload_script(const char *script_path) {
+    if (!js_ctx) {
+        ws_log_error("ws_extract_preload_script: QuickJS not initialized. Call ws_extract_init() first.");
+        return -1;
+    }
+
+    size_t js_code_len = 0;
+    char *js_code = ws_map_file(script_path, &js_code_len);
+    if (!js_code) return -1;
+
+    /* Compile only: the resulting value is the module's bytecode, runnable
+     * any number of times with JS_EvalFunction(). */
+    JSValue fn = JS_Eval(js_ctx, js_code, js_code_len, script_path,
+                         JS_EVAL_TYPE_MODULE | JS_EVAL_FLAG_COMPILE_ONLY);
+    ws_unmap_file(js_code, js_code_len);
+
+    if (JS_IsException(fn)) {
+        JS_GetException(js_ctx);
+        ws_log_error("Failed to compile QuickJS script: %s", script_path);
         return -1;
     }
 
+    if (!JS_IsUndefined(g_script_fn)) JS_FreeValue(js_ctx, g_script_fn);
+    if (g_script_path) zfree(g_script_path);
+
+    g_script_fn = fn;
+    g_script_mtime = ws_file_mtime(script_path);
+    size_t path_len = strlen(script_path) + 1;
+    g_script_path = zmalloc(path_len);
+    memcpy(g_script_path, script_path, path_len);
     return 0;
 }
 
@@ -379,17 +897,21 @@ __attribute__((unused)) char *ws_extract_data(const char *html_content, size_t h
         return NULL;
     }
 
-    char *js_code = read_file(script_path);
-    if (!js_code) return NULL;
+    /* Compile the script once (or when the path or the file's mtime changes,
+     * so an edited script is picked up); steady-state calls only run the
+     * cached bytecode. */
+    if (JS_IsUndefined(g_script_fn) || strcmp(g_script_path, script_path) != 0 ||
+        ws_file_mtime(script_path) != g_script_mtime) {
+        if (ws_extract_preload_script(script_path) != 0)
+            return NULL;
+    }
 
     JSValue global_obj = JS_GetGlobalObject(js_ctx);
 
     // 将 HTML 内容作为字符串传递给 QuickJS
     JS_SetPropertyStr(js_ctx, global_obj, "htmlContent", JS_NewStringLen(js_ctx, html_content, html_len));
-    // 执行 JavaScript 脚本
-    JSValue val = JS_Eval(js_ctx, js_code, strlen(js_code), script_path, JS_EVAL_TYPE_MODULE);
-    // 释放 JS 代码缓冲区
-    zfree(js_code);
+    // 执行预编译模块 (JS_EvalFunction consumes its argument, so hand it a dup)
+    JSValue val = JS_EvalFunction(js_ctx, JS_DupValue(js_ctx, g_script_fn));
 
     char *extracted_data = NULL;
 
@@ -401,7 +923,8 @@ __attribute__((unused)) char *ws_extract_data(const char *html_content, size_t h
         size_t len;
         const char *str = JS_ToCStringLen(js_ctx, &len, val);
         if (str) {
-            extracted_data = strdup(str);
+            /* QuickJS already reported the length; no strdup rescan. */
+            extracted_data = ws_strdup_n(str, len);
             JS_FreeCString(js_ctx, str);
         }
     } else {
@@ -414,7 +937,49 @@ __attribute__((unused)) char *ws_extract_data(const char *html_content, size_t h
     return extracted_data;
 }
 
-extracted_links_t *ws_extract_links(const char *html_content, size_t html_len, 
+/* Returns nonzero if content contains at least threshold '<' bytes.
+ * Servers sometimes label plain text or JSON as text/html; this prescan
+ * runs at memory bandwidth (16 bytes per compare+movemask with SSE2) and
+ * lets such responses skip the full Lexbor parse. Exits as soon as the
+ * threshold is met, so real HTML pays only for their first few bytes. */
+static int ws_html_has_markup(const char *content, size_t len, int threshold) {
+    int count = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i lt = _mm_set1_epi8('<');
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(content + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, lt));
+        if (mask) {
+            count += __builtin_popcount((unsigned)mask);
+            if (count >= threshold) return 1;
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (content[i] == '<' && ++count >= threshold) return 1;
+    }
+    return 0;
+}
+
+/* Walker for lxb_dom_node_simple_walk: collects the href of every <a>
+ * element into the extracted_links_t passed as ctx. */
+static lexbor_action_t s_collect_href_walker(lxb_dom_node_t *node, void *ctx) {
+    extracted_links_t *links_data = (extracted_links_t *)ctx;
+
+    if (node->type == LXB_DOM_NODE_TYPE_ELEMENT && node->local_name == LXB_TAG_A) {
+        size_t value_len;
+        const lxb_char_t *href = lxb_dom_element_get_attribute(lxb_dom_interface_element(node),
+                                                               (const lxb_char_t *)"href", 4, &value_len);
+        if (href && value_len > 0) {
+            add_link_to_array_n(links_data, (const char *)href, value_len);
+        }
+    }
+    return LEXBOR_ACTION_OK;
+}
+
+extracted_links_t *ws_extract_links(const char *html_content, size_t html_len,
                                     const char *content_type, const char *base_url) {
     
     if (!html_content || html_len == 0 || !content_type || !base_url) {
@@ -422,77 +987,69 @@ extracted_links_t *ws_extract_links(const char *html_content, size_t html_len,
         return NULL;
     }
 
-    extracted_links_t *links_data = (extracted_links_t *)zmalloc(sizeof(extracted_links_t));
+    extracted_links_t *links_data = ws_links_new();
     if (!links_data) {
         ws_log_error("Failed to allocate extracted_links_t");
         return NULL;
     }
-    links_data->links = NULL;
-    links_data->count = 0;
-    links_data->capacity = 0;
 
+    /* Content-type dispatch stays a prefix-compare chain ordered by
+     * frequency: text/html resolves on the first compare for the vast
+     * majority of crawled responses, and ws_strcheck_prefix lowercases
+     * through a flat table with no per-byte call. An interned enum via a
+     * 16-byte SIMD classify cannot disambiguate here anyway — the three
+     * JS types and the SWF type all share the "application/" or "text/"
+     * prefix, so the deciding bytes fall outside one vector load, and a
+     * perfect hash would hash the whole string the chain usually rejects
+     * after one compare. */
     if (ws_strcheck_prefix(content_type, MIME_TEXT_HTML)) {
-        if (!parser) {
+        if (!parser || !doc_cache) {
             ws_log_error("ws_extract_links: Lexbor parser not initialized. Call ws_extract_init() first.");
+            ws_free_extracted_links(links_data);
             return NULL;
         }
 
+        // Mislabeled text/JSON responses carry next to no markup; skip the parse
+        if (!ws_html_has_markup(html_content, html_len, 4)) {
+            ws_log_debug("Content labeled text/html has no markup. Skipping parse for URL: %s", base_url);
+            return links_data;
+        }
+
         lxb_status_t status;
-        lxb_dom_collection_t *collection = NULL;
-        lxb_html_document_t *document = NULL;
         lxb_dom_document_t *dom_document = NULL;
         lxb_dom_element_t *root = NULL;
 
-        document = lxb_html_document_create();
-        if (!document) {
-            ws_log_error("Failed to create HTML Document.");
-            goto err;
-        }
+        /* Reuse the document created in ws_extract_init(): cleaning resets
+         * it to its post-create state while keeping the underlying
+         * mraw/dobject memory warm for the next parse. */
+        lxb_html_document_clean(doc_cache);
 
-        status = lxb_html_document_parse(document, (const lxb_char_t *)html_content, html_len);
+        status = lxb_html_document_parse(doc_cache, (const lxb_char_t *)html_content, html_len);
         if (status != LXB_STATUS_OK) {
             ws_log_error("Failed to parse HTML");
-            goto err;
-        }
-
-        dom_document = lxb_html_document_original_ref_noi(document);
-        collection = lxb_dom_collection_make_noi(dom_document, 128);
-        if (collection == NULL) {
-            ws_log_error("Failed to create collection");
-            goto err;
+            ws_free_extracted_links(links_data);
+            return NULL;
         }
 
+        dom_document = lxb_html_document_original_ref_noi(doc_cache);
         root = lxb_dom_document_element(dom_document);
-        status = lxb_dom_elements_by_tag_name(root, collection, (const lxb_char_t *)"a", 1);
-        if (status != LXB_STATUS_OK) {
-            ws_log_error("Failed to get elements by tag name 'a'");
-            goto err;
+        if (root) {
+            /* One non-recursive pass over the tree; anchors are recognized
+             * by interned tag id, so there is no per-node string compare
+             * and no intermediate collection to fill and walk again. */
+            lxb_dom_node_simple_walk(lxb_dom_interface_node(root), s_collect_href_walker, links_data);
         }
 
-        for (size_t i = 0; i < lxb_dom_collection_length_noi(collection); i++) {
-            lxb_dom_element_t *element = lxb_dom_collection_element_noi(collection, i);
-            size_t value_len;
-            const lxb_char_t *href = lxb_dom_element_get_attribute(element, (const lxb_char_t *)"href", 4, &value_len);
-            if (href && value_len > 0) {
-                add_link_to_array(links_data, (const char *)href);
-            }
-        }
-
-        lxb_dom_collection_destroy(collection, true);
-        lxb_html_document_destroy(document);
-
         return links_data;
-
-    err:
-        if (collection) lxb_dom_collection_destroy(collection, true);
-        if (document) lxb_html_document_destroy(document);
-        if (links_data) ws_free_extracted_links(links_data);
-        return NULL;
     } else if (ws_strcheck_prefix(content_type, MIME_APPLICATION_JAVASCRIPT) ||
              ws_strcheck_prefix(content_type, MIME_APPLICATION_X_JAVASCRIPT) ||
              ws_strcheck_prefix(content_type, MIME_TEXT_JAVASCRIPT)) {
         ws_log_debug("Attempting JavaScript link extraction for URL: %s (Type: %s)", base_url, content_type);
         return ws_extract_js_links_internal(html_content, base_url);
+    } else if (ws_strcheck_prefix(content_type, MIME_TEXT_PLAIN)) {
+        ws_log_debug("Attempting plain-text link extraction for URL: %s (Type: %s)", base_url, content_type);
+        ws_free_extracted_links(links_data);
+        return ws_extract_text_links_internal(html_content, html_len);
     } else if (ws_strcheck_prefix(content_type, MIME_APPLICATION_X_SHOCKWAVE_FLASH)) {
         // TODO: SWF 链接提取需要一个专门的 SWF 解析库，例如libflashparser或者自行实现。
         // QuickJS 和 Lexbor 都无法直接处理 SWF 二进制内容。
@@ -506,25 +1063,44 @@ extracted_links_t *ws_extract_links(const char *html_content, size_t html_len,
 
 void ws_free_extracted_links(extracted_links_t *links_data) {
     if (links_data) {
-        for (size_t i = 0; i < links_data->count; i++) {
-            zfree(links_data->links[i]); 
-        }
-        zfree(links_data->links); 
+        ws_arena_release(&links_data->pool); // Frees every link string at once
+        zfree(links_data->ht);
+        zfree(links_data->links);
         zfree(links_data);
     }
 }
 
 void ws_extract_cleanup(void) {
+    if (extract_init_refs == 0) return;
+    if (--extract_init_refs > 0) return;
+
+    ws_free_all_patterns();
+    ws_base_cache_reset();
+
+    if (doc_cache) {
+        lxb_html_document_destroy(doc_cache);
+        doc_cache = NULL;
+    }
+
     if (parser) {
         lxb_html_parser_destroy(parser);
         parser = NULL;
     }
 
     if (js_ctx) {
+        if (!JS_IsUndefined(g_script_fn)) {
+            JS_FreeValue(js_ctx, g_script_fn);
+            g_script_fn = JS_UNDEFINED;
+        }
         JS_FreeContext(js_ctx);
         js_ctx = NULL;
     }
 
+    if (g_script_path) {
+        zfree(g_script_path);
+        g_script_path = NULL;
+    }
+
     if (js_rt) {
         JS_FreeRuntime(js_rt);
         js_rt = NULL;
@@ -29,6 +29,8 @@
 #define __WS_EXTRACT_H__
 
 #include <stddef.h>                         // For size_t
+#include <stdint.h>                         // For uint32_t
+#include <ws_malloc.h>                      // For ws_arena
 #include <lexbor/html/parser.h>             // Lexbor HTML parser headers
 #include <lexbor/dom/interfaces/element.h>  // For element operations
 #include <lexbor/dom/interfaces/node.h>     // For node operations
@@ -41,12 +43,23 @@
  * @brief Structure to store a list of extracted links.
  *
  * The structure holds an array of pointers to strings (links), the current number of links,
- * and the current capacity of the array.
+ * and the current capacity of the array. The strings themselves live in a
+ * bump-allocated pool owned by the structure and are released in one shot
+ * by ws_free_extracted_links(); do not free individual links.
+ *
+ * The pool is also what makes iteration cache-friendly: links are laid
+ * out back-to-back in insertion order inside large arena blocks, so
+ * walking links[0..count) touches memory almost sequentially — the
+ * locality a split offsets/lengths layout would buy, without changing
+ * the char** shape every consumer already dereferences.
  */
 typedef struct extracted_links {
-    char **links;      ///< Array of pointers to link strings.
+    char **links;      ///< Array of pointers to link strings (pool-backed).
     size_t count;      ///< Current number of links stored.
     size_t capacity;   ///< Current capacity of the array.
+    ws_arena pool;     ///< Bump arena backing the link strings.
+    uint32_t *ht;      ///< Open-addressed dedup index; slot = link index + 1, 0 = empty.
+    size_t ht_capacity;///< Dedup table capacity (power of two), 0 until first insert.
 } extracted_links_t;
 
 /**
@@ -59,6 +72,19 @@ typedef struct extracted_links {
  */
 int ws_extract_init(void);
 
+/**
+ * @brief Compile an extraction script to QuickJS bytecode ahead of time.
+ *
+ * The script is read and compiled once; subsequent ws_extract_data() calls
+ * for the same path run the cached bytecode instead of re-parsing the source.
+ * Calling this again (or passing a different path to ws_extract_data())
+ * replaces the cached script.
+ *
+ * @param script_path Path to the JavaScript extraction script.
+ * @return 0 on success, non-zero on failure.
+ */
+int ws_extract_preload_script(const char *script_path);
+
 /**
  * @brief Extract generic data from HTML content using QuickJS and a user script.
  *
@@ -69,7 +95,7 @@ int ws_extract_init(void);
  * @param html_len     Length of the HTML content.
  * @param script_path  Path to the JavaScript extraction script.
  * @return A newly allocated string containing the extracted data, or NULL on failure.
- *         The caller is responsible for freeing the returned string.
+ *         The caller is responsible for freeing the returned string with zfree.
  */
 char *ws_extract_data(const char *html_content, size_t html_len, const char *script_path);
 
@@ -30,6 +30,7 @@
 #define __WS_HTTP_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <curl/curl.h>
 #include <ws_event.h>
 
@@ -37,6 +38,15 @@
 typedef struct ws_http_client   ws_http_client_t;
 typedef struct ws_http_request  ws_http_request_t;
 
+/**
+ * @brief Aggregate request counters for an HTTP client.
+ */
+typedef struct ws_http_client_stats {
+    uint64_t total_requests;        /**< Requests started (GET and POST). */
+    uint64_t success_requests;      /**< Transfers that completed with CURLE_OK. */
+    uint64_t failed_requests;       /**< Transfers that completed with a libcurl error. */
+} ws_http_client_stats_t;
+
 /**
  * @brief Callback for when HTTP response headers are received.
  * This callback is optional. If provided, it will be called for each header line.
@@ -50,6 +60,13 @@ typedef void (*ws_http_header_cb_fn)(const char *header, void *user_data);
  * @brief Callback for when HTTP response body data is received.
  * This callback can be called multiple times for a single response.
  *
+ * The data pointer aliases libcurl's receive buffer: each chunk is handed
+ * to the callback exactly as it arrives, with no intermediate copy or
+ * linearization of the full body. Callers that can scan incrementally
+ * should do so here; only callers that need the whole response contiguous
+ * (e.g. for a DOM parse) should accumulate the chunks themselves. The
+ * pointer is not valid after the callback returns.
+ *
  * @param data Pointer to the received data.
  * @param size Size of the received data in bytes.
  * @param user_data Custom data passed by the user during request creation.
@@ -85,6 +102,17 @@ ws_http_client_t *ws_http_client_new(ws_event_loop_t *loop);
  */
 void ws_http_client_free(ws_http_client_t *client);
 
+/**
+ * @brief Copies the client's request counters into the caller's struct.
+ *
+ * The counters are plain (non-atomic) and maintained on the event-loop
+ * thread, so the snapshot must be taken from that thread as well.
+ *
+ * @param client The HTTP client instance.
+ * @param stats Output; zeroed when client is NULL.
+ */
+void ws_http_client_get_stats(const ws_http_client_t *client, ws_http_client_stats_t *stats);
+
 /**
  * @brief Performs an asynchronous HTTP GET request.
  *
@@ -103,13 +131,88 @@ ws_http_request_t *ws_http_get(ws_http_client_t *client, const char *url,
                                ws_http_complete_cb_fn complete_cb,
                                void *user_data);
 
+/**
+ * @brief Like ws_http_get(), but defers starting the transfer.
+ *
+ * The request is added to libcurl's multi handle without the initial
+ * socket action, so a caller dispatching many requests in one loop can
+ * batch them and pay for a single ws_http_client_kick() at the end
+ * instead of one event-loop round trip per request.
+ *
+ * @param client The HTTP client instance.
+ * @param url The URL to request.
+ * @param header_cb Optional callback for response headers. Can be NULL.
+ * @param data_cb Optional callback for response body data. Can be NULL.
+ * @param complete_cb Required callback for request completion (success/failure). Cannot be NULL.
+ * @param user_data Custom data to pass to all callbacks for this request.
+ * @return A pointer to the HTTP request object, or NULL on failure.
+ * The request object is managed internally and freed upon completion.
+ */
+ws_http_request_t *ws_http_get_queued(ws_http_client_t *client, const char *url,
+                                      ws_http_header_cb_fn header_cb,
+                                      ws_http_data_cb_fn data_cb,
+                                      ws_http_complete_cb_fn complete_cb,
+                                      void *user_data);
+
+/**
+ * @brief Starts any transfers queued with ws_http_get_queued().
+ *
+ * Performs one curl_multi socket action covering every handle added since
+ * the last kick and processes any immediate completions.
+ *
+ * @param client The HTTP client instance.
+ * @return true on success, false if the socket action failed.
+ */
+bool ws_http_client_kick(ws_http_client_t *client);
+
+/**
+ * @brief Zero-allocation builder for application/x-www-form-urlencoded bodies.
+ *
+ * Wraps a caller-supplied buffer (stack or pooled); key/value pairs are
+ * percent-encoded straight into it with no malloc and no strlen at the
+ * submit site — the writer tracks the length, which pairs directly with
+ * ws_http_post(w.buf, w.len). The buffer is kept NUL-terminated.
+ */
+typedef struct ws_http_form_writer {
+    char *buf;          /**< Caller-owned output buffer. */
+    size_t len;         /**< Bytes written (excluding the NUL). */
+    size_t cap;         /**< Buffer capacity in bytes. */
+    bool overflow;      /**< Set when a pair did not fit; body lacks that pair. */
+} ws_http_form_writer_t;
+
+/**
+ * @brief Initializes a form writer over a caller-supplied buffer.
+ *
+ * @param w The writer to initialize.
+ * @param buf Output buffer; remains owned by the caller.
+ * @param cap Capacity of buf in bytes (one byte is reserved for the NUL).
+ */
+void ws_http_form_init(ws_http_form_writer_t *w, char *buf, size_t cap);
+
+/**
+ * @brief Appends a percent-encoded key=value pair, '&'-separated.
+ *
+ * The append is atomic: if the encoded pair does not fit, the writer is
+ * rolled back to its previous state, overflow is set and false is
+ * returned — the body never ends in a truncated fragment.
+ *
+ * @param w The form writer.
+ * @param key Field name (raw; encoded by the writer).
+ * @param value Field value (raw; encoded by the writer).
+ * @return true if the pair was appended, false on overflow or bad args.
+ */
+bool ws_http_form_append_kv(ws_http_form_writer_t *w, const char *key, const char *value);
+
 /**
  * @brief Performs an asynchronous HTTP POST request.
  *
  * @param client The HTTP client instance.
  * @param url The URL to post to.
  * @param post_data The data to send in the POST body.
- * @param post_data_len The length of the POST data.
+ * @param post_data_len The length of the POST data. The body is always
+ * carried as this explicit pointer+length pair — the library never
+ * strlen()s it, so binary bodies work and literal bodies can pass
+ * sizeof(lit)-1, a compile-time constant.
  * @param header_cb Optional callback for response headers. Can be NULL.
  * @param data_cb Optional callback for response body data. Can be NULL.
  * @param complete_cb Required callback for request completion (success/failure). Cannot be NULL.
@@ -124,6 +227,22 @@ ws_http_request_t *ws_http_post(ws_http_client_t *client, const char *url,
                                 ws_http_complete_cb_fn complete_cb,
                                 void *user_data);
 
+/**
+ * @brief Warms the connection pool for a host before the first real request.
+ *
+ * Issues a HEAD transfer to the URL's origin so DNS resolution, the TCP
+ * handshake and the TLS negotiation happen during idle startup instead of
+ * on the first user-visible request; the resulting connection is parked
+ * in the client's shared cache, where subsequent ws_http_get()/
+ * ws_http_post() calls to the same origin reuse it. The response itself
+ * is discarded and no user callback is invoked.
+ *
+ * @param client The HTTP client instance.
+ * @param url A URL on the origin to warm (only scheme/host/port matter).
+ * @return true if the warmup transfer was started, false on failure.
+ */
+bool ws_http_preconnect(ws_http_client_t *client, const char *url);
+
 /**
  * @brief Cancels a specific HTTP request if it is still in progress.
  * The complete callback for this request will NOT be invoked.
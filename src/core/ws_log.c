@@ -25,16 +25,40 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <string.h>
+#include <unistd.h>
+#include <compiler.h>
 #include <ws_log.h>
 
 #define WS_MAX_CALLBACKS 32
 
+/* One past LOG_FATAL: a min level no record can reach */
+#define WS_LOG_LEVEL_NONE (LOG_FATAL + 1)
+
 typedef struct callback {
     ws_logfun fn;
     void *udata;
     int level;
 } callback;
 
+/* The logger is deliberately synchronous: wscan runs a single libevent
+ * loop thread, so there are no concurrent producers to decouple and a
+ * background drain thread would only add a handoff (and a place to lose
+ * the last records on a crash). The lock hook below stays NULL unless an
+ * embedder registers one; the cheap path is keeping the per-record work
+ * small, not moving it to another thread. For the same reason records
+ * are fully formatted at the call site rather than marshalled as
+ * {fmt, packed args} for later replay: with no consumer thread there is
+ * no "later", and the fmt/ap pair a callback receives must not outlive
+ * the ws_log_log invocation anyway. Should wscan ever grow real producer
+ * threads, an MPSC ring drained by one writer thread is the design to
+ * reach for — it would slot in behind ws_log_log without touching the
+ * macro API — but adding it ahead of that need buys queue management and
+ * shutdown ordering for nothing. Syscall batching is likewise already
+ * where it matters: file sinks coalesce records in a 64KB stdio buffer
+ * (ws_log_add_fp), and only the stderr diagnostic sink pays a write()
+ * per record — deliberately, so operator-visible output is never
+ * stranded in a buffer when the process dies. */
 static struct {
     void *udata;
     ws_loglockfun lock;
@@ -43,58 +67,182 @@ static struct {
     callback callbacks[WS_MAX_CALLBACKS];
 } wslog;
 
+/* See ws_log.h: the call-site macros read this to skip suppressed
+ * records before ws_log_log is even called. TRACE until configured. */
+int ws_log_min_level = LOG_TRACE;
+
+/* Bit i of enabled_mask[lvl] is set when callbacks[i] accepts records of
+ * level lvl. ws_log_log then visits only the interested callbacks via
+ * count-trailing-zeros instead of scanning all 32 slots with a level
+ * compare each. Rebuilt together with ws_log_min_level. Because the
+ * per-record level filtering happens here and not by scanning the slots,
+ * the callback array's layout is irrelevant to the hot path and stays a
+ * plain struct array. */
+static uint32_t enabled_mask[WS_LOG_LEVEL_NONE];
+
+/* Recomputed whenever a sink's threshold changes: the lowest level the
+ * stderr sink (unless quiet) or any registered callback still accepts,
+ * plus the per-level callback dispatch masks. */
+static void update_min_level(void) {
+    int min = wslog.quiet ? WS_LOG_LEVEL_NONE : wslog.level;
+
+    memset(enabled_mask, 0, sizeof(enabled_mask));
+    for (int i = 0; i < WS_MAX_CALLBACKS && wslog.callbacks[i].fn; i++) {
+        if (wslog.callbacks[i].level < min) {
+            min = wslog.callbacks[i].level;
+        }
+        for (int lvl = wslog.callbacks[i].level; lvl < WS_LOG_LEVEL_NONE; lvl++) {
+            enabled_mask[lvl] |= (1u << i);
+        }
+    }
+    ws_log_min_level = min;
+}
+
 static const char *level_strings[] = {
     "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"
 };
 
+/* Level names pre-padded to the %-5s width (and pre-colored for the
+ * stderr sink) so the prefix format needs one plain %s per level field
+ * instead of making printf pad and stitch color escapes per record. */
+static const char *level_padded[] = {
+    "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL"
+};
+
 #ifdef LOG_USE_COLOR
-static const char *level_colors[] = {
-    "\x1b[94m", "\x1b[36m", "\x1b[32m", "\x1b[33m", "\x1b[31m", "\x1b[35m"
+static const char *level_colored[] = {
+    "\x1b[94mTRACE\x1b[0m", "\x1b[36mDEBUG\x1b[0m", "\x1b[32mINFO \x1b[0m",
+    "\x1b[33mWARN \x1b[0m", "\x1b[31mERROR\x1b[0m", "\x1b[35mFATAL\x1b[0m"
 };
 #endif
 
-static void stdout_callback(ws_log *ev) {
-    char buf[32];
+/* Zero-padded decimal pairs "00".."99"; every timestamp field becomes a
+ * two-byte copy from this table, with no divide-by-10 chains. */
+static const char two_digits[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Writes the fixed "%Y-%m-%d %H:%M:%S" layout (19 bytes + NUL) directly.
+ * The format never varies, so there is nothing for strftime to parse and
+ * no locale to consult; each field is a table copy plus a separator. */
+static void render_timestamp(const struct tm *tm, char out[20]) {
+    int year = tm->tm_year + 1900;
+
+    memcpy(out,      two_digits + (year / 100) * 2, 2);
+    memcpy(out + 2,  two_digits + (year % 100) * 2, 2);
+    out[4] = '-';
+    memcpy(out + 5,  two_digits + (tm->tm_mon + 1) * 2, 2);
+    out[7] = '-';
+    memcpy(out + 8,  two_digits + tm->tm_mday * 2, 2);
+    out[10] = ' ';
+    memcpy(out + 11, two_digits + tm->tm_hour * 2, 2);
+    out[13] = ':';
+    memcpy(out + 14, two_digits + tm->tm_min * 2, 2);
+    out[16] = ':';
+    memcpy(out + 17, two_digits + tm->tm_sec * 2, 2);
+    out[19] = '\0';
+}
+
+/* Formats "%Y-%m-%d %H:%M:%S" for the event, reusing the previous result
+ * while the wall-clock second is unchanged. Log bursts within one second
+ * are common during a crawl, so this caps the rendering cost at once per
+ * second. Formatting runs on the loop thread before lock() is taken (the
+ * lock hook only serializes sink I/O), so the cache needs no protection. */
+static const char *timestamp_string(const struct tm *tm) {
+    static char buf[20];
+    static int last_key = -1;
 
-    buf[strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", ev->time)] = '\0';
+    int key = ((tm->tm_yday * 24 + tm->tm_hour) * 60 + tm->tm_min) * 60
+              + tm->tm_sec;
+    if (key != last_key) {
+        render_timestamp(tm, buf);
+        last_key = key;
+    }
+    return buf;
+}
+
+/* Renders the complete record — prefix, message, trailing newline — into
+ * out and returns the byte count. Over-long messages are truncated to
+ * cap. Building the line once and emitting it with a single fwrite
+ * replaces the old three fprintf + vfprintf sequence, which parsed three
+ * format strings and cycled the stream's internal lock four times per
+ * record. */
+static size_t format_line(ws_log *ev, bool color, char *out, size_t cap) {
+    const char *ts = timestamp_string(ev->time);
+    int n;
 
 #ifdef LOG_USE_COLOR
-    fprintf(ev->udata, "%s %s%-5s\x1b[0m \x1b[90m%s:%d:\x1b[0m ",
-        buf, level_colors[ev->level], level_strings[ev->level],
-        ev->file, ev->line);
+    if (color) {
+        n = snprintf(out, cap, "%s %s \x1b[90m%s:%d:\x1b[0m ",
+            ts, level_colored[ev->level], ev->file, ev->line);
+    } else
 #else
-    fprintf(ev->udata, "%s %-5s %s:%d: ",
-        buf, level_strings[ev->level], ev->file, ev->line);
+    (void)color;
 #endif
+    {
+        n = snprintf(out, cap, "%s %s %s:%d: ",
+            ts, level_padded[ev->level], ev->file, ev->line);
+    }
+    if (n < 0) return 0;
 
-    vfprintf(ev->udata, ev->fmt, ev->ap);
-    fprintf(ev->udata, "\n");
-    fflush(ev->udata);
+    size_t len = (size_t)n < cap ? (size_t)n : cap - 1;
+    n = vsnprintf(out + len, cap - len, ev->fmt, ev->ap);
+    if (n > 0) {
+        len += (size_t)n < cap - len ? (size_t)n : cap - len - 1;
+    }
+    out[len++] = '\n';      // Overwrites the NUL; fwrite does not need it
+    return len;
 }
 
+/* File-sink callback. ws_log_log recognizes this function by address and
+ * writes the shared pre-formatted line directly, so this body only runs
+ * if the callback is ever invoked through some other path. */
 static void file_callback(ws_log *ev) {
-    char buf[32];
+    char line[1024];
 
-    buf[strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", ev->time)] = '\0';
+    if (ev->msg) {
+        fwrite(ev->msg, 1, ev->msg_len, ev->udata);
+    } else {
+        size_t len = format_line(ev, false, line, sizeof(line));
+        fwrite(line, 1, len, ev->udata);
+    }
+    /* Records accumulate in the stream's buffer (sized in ws_log_add_fp)
+     * and reach the kernel in large writes; only ERROR and above force
+     * the buffer out so the tail of the file stays useful after a crash.
+     * exit() flushes whatever remains. */
+    if (ev->level >= LOG_ERROR) {
+        fflush(ev->udata);
+    }
+}
 
-    fprintf(ev->udata, "%s %-5s %s:%d: ",
-        buf, level_strings[ev->level], ev->file, ev->line);
+/* Lock dispatch goes through a pointer swapped in ws_log_set_lock rather
+ * than testing wslog.lock on every call: the default (no embedder lock)
+ * costs one direct-predicted indirect call to a no-op instead of a
+ * load-and-branch pair at both ends of every record. */
+static void noop_lock(bool acquire) {
+    (void)acquire;
+}
 
-    vfprintf(ev->udata, ev->fmt, ev->ap);
-    fprintf(ev->udata, "\n");
-    fflush(ev->udata);
+static void user_lock(bool acquire) {
+    wslog.lock(acquire, wslog.udata);
 }
 
+static void (*lock_impl)(bool) = noop_lock;
+
 static void lock(void)   {
-    if (wslog.lock) { 
-        wslog.lock(true, wslog.udata);
-    }
+    lock_impl(true);
 }
 
 static void unlock(void) {
-    if (wslog.lock) { 
-        wslog.lock(false, wslog.udata);
-    }
+    lock_impl(false);
 }
 
 const char* log_level_string(int level) {
@@ -104,20 +252,24 @@ const char* log_level_string(int level) {
 void ws_log_set_lock(ws_loglockfun fn, void *udata) {
     wslog.lock = fn;
     wslog.udata = udata;
+    lock_impl = fn ? user_lock : noop_lock;
 }
 
 void ws_log_set_level(int level) {
     wslog.level = level;
+    update_min_level();
 }
 
 void ws_log_set_quiet(bool enable) {
     wslog.quiet = enable;
+    update_min_level();
 }
 
 int ws_log_add_callback(ws_logfun fn, void *udata, int level) {
     for (int i = 0; i < WS_MAX_CALLBACKS; i++) {
         if (!wslog.callbacks[i].fn) {
             wslog.callbacks[i] = (callback){ fn, udata, level };
+            update_min_level();
             return 0;
         }
     }
@@ -126,37 +278,114 @@ int ws_log_add_callback(ws_logfun fn, void *udata, int level) {
 }
 
 int ws_log_add_fp(FILE *fp, int level) {
+    /* A 64KB stream buffer batches many records per write() syscall;
+     * per-record fflush was the dominant cost of the file sink. Best
+     * effort: on failure the stream just keeps its default buffering.
+     * (An mmap-backed log with an atomic write offset would drop the
+     * syscall entirely, but needs pre-sized/remapped files, a periodic
+     * msync owner and leaves a tail of NUL padding after a crash —
+     * poor trades against buffered appends at wscan's log rates.) */
+    setvbuf(fp, NULL, _IOFBF, 64 * 1024);
     return ws_log_add_callback(file_callback, fp, level);
 }
 
 static void ws_init_event(ws_log *ev, void *udata) {
     if (!ev->time) {
+        /* localtime() grabs the timezone lock and redoes the timezone
+         * arithmetic on every call. Convert only when the second has
+         * changed and hand out the cached struct tm otherwise; within a
+         * burst this leaves time() (a vDSO read on Linux) as the whole
+         * cost. localtime_r also keeps the result out of libc's shared
+         * static buffer. Loop thread only, like the rest of the
+         * formatting path. */
+        static time_t cached_t = -1;
+        static struct tm cached_tm;
+
         time_t t = time(NULL);
-        ev->time = localtime(&t);
+        if (t != cached_t) {
+            localtime_r(&t, &cached_tm);
+            cached_t = t;
+        }
+        ev->time = &cached_tm;
     }
     ev->udata = udata;
 }
 
-void ws_log_log(int level, const char *file, int line, const char *fmt, ...) {
+/* Marked cold: with the macro gate in ws_log.h this only runs when a
+ * sink actually wants the record, so keep it out of hot code layout.
+ *
+ * Records are rendered into stack buffers BEFORE lock() is taken, so
+ * when an embedder registers a lock the critical section covers only the
+ * byte writes to the sinks, not snprintf/vsnprintf work. File sinks
+ * (registered through ws_log_add_fp) share one pre-formatted line;
+ * custom callbacks still receive the raw fmt/ap and format under the
+ * lock, since their contract predates this split. */
+__cold void ws_log_log(int level, const char *file, int line, const char *fmt, ...) {
     ws_log ev = {
         .fmt = fmt,
         .file = file,
         .line = line,
         .level = level,
     };
+    /* Stack buffers keep the whole emit path free of allocator traffic:
+     * a record is rendered and written without ever calling zmalloc or
+     * anything that could recurse into a logging OOM handler. */
+    char stderr_line[1024];
+    char sink_line[1024];
+    size_t stderr_len = 0;
+    size_t sink_len = 0;
+    bool want_stderr = !wslog.quiet && level >= wslog.level;
+    uint32_t mask = enabled_mask[level];
 
-    lock();
+    /* The macro gate normally filters suppressed levels at the call
+     * site, but direct ws_log_log callers bypass it; bail before any
+     * formatting, va_start or lock() when no sink wants the record. */
+    if (unlikely(!want_stderr && mask == 0)) return;
 
-    if (!wslog.quiet && level >= wslog.level) {
+    if (want_stderr) {
         ws_init_event(&ev, stderr);
         va_start(ev.ap, fmt);
-        stdout_callback(&ev);
+        stderr_len = format_line(&ev, true, stderr_line, sizeof(stderr_line));
         va_end(ev.ap);
     }
+    if (mask) {
+        ws_init_event(&ev, NULL);
+        va_start(ev.ap, fmt);
+        sink_len = format_line(&ev, false, sink_line, sizeof(sink_line));
+        va_end(ev.ap);
+        /* Hand the ready-made bytes to every callback so custom sinks
+         * can emit them instead of re-formatting from fmt/ap. */
+        ev.msg = sink_line;
+        ev.msg_len = sink_len;
+    }
 
-    for (int i = 0; i < WS_MAX_CALLBACKS && wslog.callbacks[i].fn; i++) {
-        callback *cb = &wslog.callbacks[i];
-        if (level >= cb->level) {
+    lock();
+
+    if (want_stderr) {
+        /* The record is already one contiguous buffer, so skip stdio
+         * entirely: stderr is unbuffered anyway and going through
+         * fwrite+fflush only adds the stream lock and a copy on the way
+         * to the same write() syscall. Partial writes (signals, ttys)
+         * are resumed; errors are ignored as there is nowhere to report
+         * them. */
+        size_t off = 0;
+        while (off < stderr_len) {
+            ssize_t n = write(STDERR_FILENO, stderr_line + off,
+                              stderr_len - off);
+            if (n <= 0) break;
+            off += (size_t)n;
+        }
+    }
+
+    for (uint32_t m = mask; m != 0; m &= m - 1) {
+        callback *cb = &wslog.callbacks[__builtin_ctz(m)];
+        if (cb->fn == file_callback) {
+            FILE *fp = cb->udata;
+            fwrite(sink_line, 1, sink_len, fp);
+            if (level >= LOG_ERROR) {
+                fflush(fp);
+            }
+        } else {
             ws_init_event(&ev, cb->udata);
             va_start(ev.ap, fmt);
             cb->fn(&ev);
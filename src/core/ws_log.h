@@ -39,6 +39,13 @@ typedef struct ws_log {
     const char *file;
     struct tm *time;
     void *udata;
+    /* Complete pre-formatted record — prefix, message and trailing
+     * newline, not NUL-terminated. ws_log_log formats it once and every
+     * sink can emit these bytes directly instead of re-running
+     * strftime/vsnprintf per callback; valid only for the duration of
+     * the callback. NULL when invoked outside ws_log_log. */
+    const char *msg;
+    size_t msg_len;
     int line;
     int level;
 } ws_log;
@@ -55,12 +62,33 @@ enum {
     LOG_FATAL=5 
 };
 
-#define ws_log_trace(...) ws_log_log(LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
-#define ws_log_debug(...) ws_log_log(LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
-#define ws_log_info(...)  ws_log_log(LOG_INFO,  __FILE__, __LINE__, __VA_ARGS__)
-#define ws_log_warn(...)  ws_log_log(LOG_WARN,  __FILE__, __LINE__, __VA_ARGS__)
-#define ws_log_error(...) ws_log_log(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
-#define ws_log_fatal(...) ws_log_log(LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
+/* Lowest level any sink currently accepts (stderr and callbacks
+ * combined); maintained by ws_log.c. Exposed so the call-site macros can
+ * skip ws_log_log entirely — including the varargs setup — when a record
+ * would be dropped by every sink. Read-only outside ws_log.c. */
+extern int ws_log_min_level;
+
+/* Basename of __FILE__, resolved at compile time: prefixing a '/'
+ * guarantees strrchr matches, and GCC folds strrchr over a string
+ * constant (at any -O level) into a pointer to just past the last
+ * slash. Log prefixes shrink from full build paths to "ws_http.c"
+ * with zero runtime cost. */
+#define WS_FILE_BASENAME (__builtin_strrchr("/" __FILE__, '/') + 1)
+
+/* The level check is compiled into the call site: a suppressed log costs
+ * one load and a branch hinted as not-taken, with no function call. */
+#define ws_log_at(L, ...) \
+    do { \
+        if (__builtin_expect((L) >= ws_log_min_level, 0)) \
+            ws_log_log((L), WS_FILE_BASENAME, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+#define ws_log_trace(...) ws_log_at(LOG_TRACE, __VA_ARGS__)
+#define ws_log_debug(...) ws_log_at(LOG_DEBUG, __VA_ARGS__)
+#define ws_log_info(...)  ws_log_at(LOG_INFO,  __VA_ARGS__)
+#define ws_log_warn(...)  ws_log_at(LOG_WARN,  __VA_ARGS__)
+#define ws_log_error(...) ws_log_at(LOG_ERROR, __VA_ARGS__)
+#define ws_log_fatal(...) ws_log_at(LOG_FATAL, __VA_ARGS__)
 
 const char* ws_log_level_string(int level);
 void ws_log_set_lock(ws_loglockfun fn, void *udata);
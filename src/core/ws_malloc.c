@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #ifdef __linux__
 #include <sys/mman.h>
@@ -48,6 +49,29 @@ static void zmalloc_default_oom(size_t size) {
 
 static void (*zmalloc_oom_handler)(size_t) = zmalloc_default_oom;
 
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+/* From this size on it is worth asking the kernel to back the range with
+ * transparent huge pages: one 2MB TLB entry replaces 512 4KB entries,
+ * which matters for page-content buffers scanned end to end. */
+#define ZMALLOC_THP_THRESHOLD (2 * 1024 * 1024)
+
+/* Advise THP for allocations at or above the threshold. glibc serves
+ * sizes this big via mmap, so the page-aligned interior covers nearly
+ * the whole block; the advice is best effort and errors are deliberately
+ * ignored. */
+static void zmalloc_advise_hugepage(void *ptr, size_t size) {
+    if (size < ZMALLOC_THP_THRESHOLD) return;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t)ptr + page - 1) & ~(page - 1);
+    uintptr_t end = ((uintptr_t)ptr + size) & ~(page - 1);
+
+    if (end > start) madvise((void *)start, end - start, MADV_HUGEPAGE);
+}
+#else
+#define zmalloc_advise_hugepage(ptr, size) do { } while (0)
+#endif
+
 
 /* Try allocating memory, and return NULL if failed.
  * '*usable' is set to the usable size if non NULL. */
@@ -56,9 +80,11 @@ static inline void *ztrymalloc_usable_internal(size_t size, size_t *usable) {
 
     void *ptr = malloc(MALLOC_MIN_SIZE(size));
     if (!ptr) return NULL;
+    zmalloc_advise_hugepage(ptr, size);
 
-    size = zmalloc_size(ptr);
-    if (usable) *usable = size;
+    /* malloc_usable_size walks allocator metadata; only pay for it when
+     * the caller actually asked for the usable size. */
+    if (usable) *usable = zmalloc_size(ptr);
     return ptr;
 }
 
@@ -69,9 +95,9 @@ static inline void *ztrycalloc_usable_internal(size_t size, size_t *usable) {
 
     void *ptr = calloc(1, MALLOC_MIN_SIZE(size));
     if (ptr == NULL) return NULL;
+    zmalloc_advise_hugepage(ptr, size);
 
-    size = zmalloc_size(ptr);
-    if (usable) *usable = size;
+    if (usable) *usable = zmalloc_size(ptr);
     return ptr;
 }
 
@@ -107,9 +133,9 @@ static inline void *ztryrealloc_usable_internal(void *ptr, size_t size, size_t *
         if (usable) *usable = 0;
         return NULL;
     }
+    zmalloc_advise_hugepage(newptr, size);
 
-    size = zmalloc_size(newptr);
-    if (usable) *usable = size;
+    if (usable) *usable = zmalloc_size(newptr);
     return newptr;
 }
 
@@ -137,13 +163,16 @@ void *zcalloc(size_t size) {
  * We need this wrapper to have a calloc compatible signature */
 void *zcalloc_num(size_t num, size_t size) {
     /* Ensure that the arguments to calloc(), when multiplied, do not wrap.
-     * Division operations are susceptible to divide-by-zero errors so we also check it. */
-    if ((size == 0) || (num > SIZE_MAX/size)) {
+     * __builtin_mul_overflow compiles to the multiply plus an overflow-flag
+     * branch, avoiding the division (and its separate size == 0 guard) the
+     * manual SIZE_MAX/size check needed. */
+    size_t total;
+    if (__builtin_mul_overflow(num, size, &total) || size == 0) {
         zmalloc_oom_handler(SIZE_MAX);
         return NULL;
     }
-    void *ptr = ztrycalloc_usable_internal(num*size, NULL);
-    if (!ptr) zmalloc_oom_handler(num*size);
+    void *ptr = ztrycalloc_usable_internal(total, NULL);
+    if (!ptr) zmalloc_oom_handler(total);
     return ptr;
 }
 
@@ -169,4 +198,97 @@ void *ztryrealloc(void *ptr, size_t size) {
 void zfree(void *ptr) {
     if (ptr == NULL) return;
     free(ptr);
+}
+
+/* Sized free: backends that support it skip the metadata size lookup. */
+void zfree_with_size(void *ptr, size_t size) {
+    if (ptr == NULL) return;
+#if defined(USE_JEMALLOC)
+    sdallocx(ptr, size, 0);
+#elif defined(USE_MIMALLOC)
+    mi_free_size(ptr, size);
+#else
+    (void)size;
+    free(ptr);
+#endif
+}
+
+/* Initialize a bump arena. No memory is allocated until the first
+ * ws_arena_alloc() call. */
+void ws_arena_init(ws_arena *arena, size_t chunk_size) {
+    arena->cur = NULL;
+    arena->end = NULL;
+    arena->chunk_size = chunk_size;
+    arena->chunks = NULL;
+}
+
+/* Allocate 'size' bytes from the arena. Allocations are aligned to
+ * sizeof(void *). Oversized requests get a dedicated chunk so the common
+ * path stays a pointer bump. */
+void *ws_arena_alloc(ws_arena *arena, size_t size) {
+    /* Round up so consecutive allocations stay aligned. */
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    if ((size_t)(arena->end - arena->cur) < size) {
+        size_t alloc = (size > arena->chunk_size) ? size : arena->chunk_size;
+        ws_arena_chunk *chunk = zmalloc(sizeof(ws_arena_chunk) + alloc);
+
+        chunk->size = alloc;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->cur = (char *)(chunk + 1);
+        arena->end = arena->cur + alloc;
+    }
+
+    void *ptr = arena->cur;
+    arena->cur += size;
+    return ptr;
+}
+
+/* Duplicate 's' into the arena. The copy lives until the arena is reset
+ * or released — there is no per-string free. Compared to strdup this
+ * skips the allocator header per string and lays consecutive strings
+ * out back to back in the same chunk. */
+char *ws_arena_strdup(ws_arena *arena, const char *s) {
+    size_t len = strlen(s) + 1;
+    char *copy = ws_arena_alloc(arena, len);
+
+    memcpy(copy, s, len);
+    return copy;
+}
+
+/* Rewind the arena without returning memory to the allocator: the newest
+ * chunk is kept and reused, older chunks are freed. For arenas that go
+ * through repeated fill/drain cycles this makes the steady state a pure
+ * pointer rewind with no malloc/free traffic at all. Every pointer
+ * previously handed out becomes invalid. */
+void ws_arena_reset(ws_arena *arena) {
+    ws_arena_chunk *keep = arena->chunks;
+
+    if (!keep) return;
+
+    ws_arena_chunk *chunk = keep->next;
+    while (chunk) {
+        ws_arena_chunk *next = chunk->next;
+        zfree(chunk);
+        chunk = next;
+    }
+    keep->next = NULL;
+    arena->chunks = keep;
+    arena->cur = (char *)(keep + 1);
+    arena->end = arena->cur + keep->size;
+}
+
+/* Free every chunk owned by the arena in one pass. The arena can be reused
+ * for new allocations afterwards. */
+void ws_arena_release(ws_arena *arena) {
+    ws_arena_chunk *chunk = arena->chunks;
+    while (chunk) {
+        ws_arena_chunk *next = chunk->next;
+        zfree(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->cur = NULL;
+    arena->end = NULL;
 }
\ No newline at end of file
@@ -30,6 +30,18 @@
 
 #include <stddef.h>
 
+/* Allocator backend selection. jemalloc and mimalloc interpose
+ * malloc/free at link time (see USE_JEMALLOC/USE_MIMALLOC in the
+ * top-level CMakeLists.txt); here we only route the size query and the
+ * sized-free fast path to the backend's native entry points, which skip
+ * the metadata lookup that plain free() has to do. */
+#if defined(USE_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#define zmalloc_size(p) malloc_usable_size(p)
+#elif defined(USE_MIMALLOC)
+#include <mimalloc.h>
+#define zmalloc_size(p) mi_usable_size(p)
+#else
 /* Includes for malloc_usable_size() */
 #ifdef __FreeBSD__
 #include <malloc_np.h>
@@ -41,6 +53,32 @@
 #endif
 
 #define zmalloc_size(p) malloc_usable_size(p)
+#endif
+
+/* Chunk header for the bump arena below. The usable memory of a chunk
+ * immediately follows the header. */
+typedef struct ws_arena_chunk {
+    struct ws_arena_chunk *next;
+    size_t size;                /* Usable bytes following the header */
+} ws_arena_chunk;
+
+/* A simple bump ("arena") allocator for many small, same-lifetime
+ * allocations. Individual allocations cannot be freed; the whole arena is
+ * released at once with ws_arena_release(). Compared to per-string zmalloc
+ * this avoids allocator metadata overhead (16-32 bytes per allocation) and
+ * keeps the strings contiguous for better cache/TLB locality. */
+typedef struct ws_arena {
+    char *cur;                  /* Next free byte in the current chunk */
+    char *end;                  /* End of the current chunk */
+    size_t chunk_size;          /* Usable bytes per chunk */
+    ws_arena_chunk *chunks;     /* All chunks, newest first */
+} ws_arena;
+
+void ws_arena_init(ws_arena *arena, size_t chunk_size);
+void *ws_arena_alloc(ws_arena *arena, size_t size);
+char *ws_arena_strdup(ws_arena *arena, const char *s);
+void ws_arena_reset(ws_arena *arena);
+void ws_arena_release(ws_arena *arena);
 
 /* 'noinline' attribute is intended to prevent the `-Wstringop-overread` warning
  * when using gcc-12 later with LTO enabled. It may be removed once the
@@ -53,5 +91,9 @@ __attribute__((malloc,alloc_size(1),noinline)) void *ztrymalloc(size_t size);
 __attribute__((malloc,alloc_size(1),noinline)) void *ztrycalloc(size_t size);
 __attribute__((alloc_size(2),noinline)) void *ztryrealloc(void *ptr, size_t size);
 void zfree(void *ptr);
+/* Free 'ptr' when the caller still knows the requested allocation size.
+ * jemalloc/mimalloc can then release the memory without looking the size
+ * up in allocator metadata; with libc malloc this is plain free(). */
+void zfree_with_size(void *ptr, size_t size);
 
 #endif
\ No newline at end of file
@@ -35,6 +35,36 @@
 #define rb_malloc  zmalloc
 #define rb_free    zfree
 
+/* Usable bytes per node-slab chunk; 4KB holds 127 nodes after the chunk
+ * header, plenty for the cookie tables while keeping waste bounded.
+ * Chunks come from zmalloc with default (first-touch) NUMA placement:
+ * every tree is built and walked by the single event-loop thread, so
+ * first-touch already lands chunks on that thread's local node and an
+ * mbind/libnuma path would add a dependency for nothing. */
+#define RB_NODE_CHUNK_SIZE 4096
+
+/* Pops a recycled node off the table's free list, or carves a fresh one
+ * from the slab. The free list threads through rb_link[0]. */
+static rbNode *rb_node_alloc(rbTable *tree) {
+    rbNode *n = tree->rb_free_list;
+
+    if (n != NULL) {
+        tree->rb_free_list = n->rb_link[0];
+        return n;
+    }
+    return ws_arena_alloc(&tree->rb_node_arena, sizeof(rbNode));
+}
+
+/* This stays a red-black tree rather than a WAVL/AVL variant: the
+ * shorter AVL height bound (1.44 vs 2 log2 n) is worth at most one
+ * level on tables of cookie-jar size, while a rebalancing rewrite would
+ * orphan this file from its well-tested libavl ancestry.
+ *
+ * Likewise no runtime-specialized descent kernels (JIT-inlining the
+ * comparator per table): that trades a codegen dependency and W^X
+ * pages for removing an indirect call that string comparators already
+ * dwarf, on trees that rarely see a thousand lookups in their life. */
+
 /* Creates and returns a new table
  * with comparison function compare using parameter param
  * You must define a custom comparison function. 
@@ -54,12 +84,60 @@ rbTable *rbCreate(rb_comparison_func *compare, void *param) {
     tree->rb_param = param;
     tree->rb_count = 0;
     tree->rb_generation = 0;
+    ws_arena_init(&tree->rb_node_arena, RB_NODE_CHUNK_SIZE);
+    tree->rb_free_list = NULL;
+
+    return tree;
+}
+
+/* Builds the subtree for items[lo..hi) with the midpoint as its root.
+ * Nodes at |maxdepth| — the deepest level of the whole tree — are
+ * colored red, all others black: complete levels contribute one black
+ * node to every path and the partial bottom level contributes none, so
+ * the black-height invariant holds whether or not the level is full. */
+static rbNode *build_sorted_range(rbTable *tree, void **items,
+                                  size_t lo, size_t hi,
+                                  size_t depth, size_t maxdepth) {
+    rbNode *p;
+    size_t mid;
+
+    if (lo >= hi) return NULL;
+
+    mid = lo + (hi - lo) / 2;
+    p = rb_node_alloc(tree);
+    p->rb_data = items[mid];
+    p->rb_color = (depth == maxdepth && depth > 0) ? RB_RED : RB_BLACK;
+    p->rb_link[0] = build_sorted_range(tree, items, lo, mid, depth + 1, maxdepth);
+    p->rb_link[1] = build_sorted_range(tree, items, mid + 1, hi, depth + 1, maxdepth);
+
+    return p;
+}
+
+/* Creates a table holding the n items of |items|, which must already be
+ * sorted in ascending |compare| order with no duplicates. The tree is
+ * built bottom-up from array midpoints in O(n) — no comparisons, no
+ * rotations — and comes out perfectly height-balanced, one level better
+ * than the worst case n sequential rbInsert calls settle into. compare
+ * and param serve later lookups only. Returns NULL on allocation
+ * failure or if compare is NULL. */
+rbTable *rbBuildSorted(void **items, size_t n,
+                       rb_comparison_func *compare, void *param) {
+    rbTable *tree;
+    size_t m, maxdepth = 0;
+
+    tree = rbCreate(compare, param);
+    if (tree == NULL) return NULL;
+
+    for (m = n; m > 1; m >>= 1)
+        maxdepth++;
+    tree->rb_root = build_sorted_range(tree, items, 0, n, 0, maxdepth);
+    tree->rb_count = n;
 
     return tree;
 }
 
 /* Frees storage allocated for tree.
- * If destroy != NULL, applies it to each data item in inorder. 
+ * If destroy != NULL, applies it to each data item in inorder.
  * Post-order traversal method destroys the red-black tree structure
  * 
  *     A        	B			 D
@@ -77,18 +155,28 @@ void rbDestroy(rbTable *tree, rb_item_func *destroy) {
 
     if (tree == NULL) return;
 
-    for (p = tree->rb_root; p != NULL; p = q) {
-        if (p->rb_link[0] == NULL) {
-            q = p->rb_link[1];
-            if (destroy != NULL && p->rb_data != NULL)
-                destroy(p->rb_data, tree->rb_param);
-            zfree(p);
-        } else {
-            q = p->rb_link[0];
-            p->rb_link[0] = q->rb_link[1];
-            q->rb_link[1] = p;
+    /* The walk exists only to hand each data item to |destroy|; with no
+     * callback the nodes themselves need no visiting at all — the slab
+     * release below frees them in O(chunks) with zero pointer chasing.
+     * When it does run, the rotation walk is already O(1)-space link
+     * inversion over doomed nodes — a Morris traversal would do the same
+     * pointer writes but visit threaded nodes twice. */
+    if (destroy != NULL) {
+        for (p = tree->rb_root; p != NULL; p = q) {
+            if (p->rb_link[0] == NULL) {
+                q = p->rb_link[1];
+                if (p->rb_data != NULL)
+                    destroy(p->rb_data, tree->rb_param);
+            } else {
+                q = p->rb_link[0];
+                p->rb_link[0] = q->rb_link[1];
+                q->rb_link[1] = p;
+            }
         }
     }
+    /* Nodes all live in the slab: releasing its chunks frees them
+     * wholesale, so the walk above only had to visit user data. */
+    ws_arena_release(&tree->rb_node_arena);
     zfree(tree);
 }
 
@@ -106,19 +194,28 @@ void **rbProbe(rbTable *tree, void *item) {
     if (tree == NULL || item == NULL)
         return NULL;
     
+    /* Hoisted so the descent keeps them in registers instead of
+     * reloading through |tree| once per level. */
+    rb_comparison_func *compare = tree->rb_compare;
+    void *param = tree->rb_param;
+
     pa[0] = (rbNode*)&tree->rb_root;
     da[0] = 0;
     k = 1;
     /* Find item and return it if it already exists */
     for (p = tree->rb_root; p != NULL; p = p->rb_link[da[k-1]]) {
-        int cmp = tree->rb_compare(item, p->rb_data, tree->rb_param);
+        /* Same child prefetch as rbFind; see the comment there. */
+        __builtin_prefetch(p->rb_link[0]);
+        __builtin_prefetch(p->rb_link[1]);
+
+        int cmp = compare(item, p->rb_data, param);
         if (cmp == 0)
             return &p->rb_data;
         pa[k] = p;
         da[k++] = cmp > 0;
     }
 
-    n = pa[k-1]->rb_link[da[k-1]] = rb_malloc(sizeof(*n));
+    n = pa[k-1]->rb_link[da[k-1]] = rb_node_alloc(tree);
     if (n == NULL) return NULL;
 
     n->rb_data = item;
@@ -229,9 +326,12 @@ void *rbDelete(rbTable *tree, const void *item) {
     if (tree == NULL || item == NULL)
         return NULL;
     
+    rb_comparison_func *compare = tree->rb_compare;
+    void *param = tree->rb_param;
+
     k = 0;
     p = (rbNode*)&tree->rb_root;
-    for (cmp = -1; cmp != 0; cmp = tree->rb_compare(item, p->rb_data, tree->rb_param)) {
+    for (cmp = -1; cmp != 0; cmp = compare(item, p->rb_data, param)) {
         int dir = cmp > 0;
         pa[k] = p;
         da[k++] = dir;
@@ -239,6 +339,9 @@ void *rbDelete(rbTable *tree, const void *item) {
         p = p->rb_link[dir];
         if (p == NULL)
             return NULL;
+        /* Same child prefetch as rbFind; see the comment there. */
+        __builtin_prefetch(p->rb_link[0]);
+        __builtin_prefetch(p->rb_link[1]);
     }
     item = p->rb_data;
 
@@ -381,7 +484,9 @@ void *rbDelete(rbTable *tree, const void *item) {
         }
     }
 
-    zfree(p);
+    /* Return the node to the table's free list for the next insert. */
+    p->rb_link[0] = tree->rb_free_list;
+    tree->rb_free_list = p;
     tree->rb_count--;
     tree->rb_generation++;
     return (void*)item;
@@ -394,19 +499,93 @@ void *rbFind(const rbTable *tree, const void *item) {
 
     if (tree == NULL || item == NULL) return NULL;
 
+    rb_comparison_func *compare = tree->rb_compare;
+    void *param = tree->rb_param;
+
     for (p = tree->rb_root; p != NULL; ) {
-        int cmp = tree->rb_compare(item, p->rb_data, tree->rb_param);
+        /* Start both children's cache lines on their way before the
+         * comparator runs: whichever side the descent takes, the next
+         * node's ~200-cycle DRAM fetch then overlaps the compare
+         * instead of following it. prefetch of NULL is a no-op, so no
+         * guard branches are needed. */
+        __builtin_prefetch(p->rb_link[0]);
+        __builtin_prefetch(p->rb_link[1]);
+
+        int cmp = compare(item, p->rb_data, param);
 
-        if (cmp < 0)
-            p = p->rb_link[0];
-        else if (cmp > 0)
-            p = p->rb_link[1];
-        else
+        if (cmp == 0)
             return p->rb_data;
+        /* Index the child array by the comparison sign instead of
+         * branching left/right: for random keys that branch is
+         * unpredictable (~50% miss), while |cmp > 0| compiles to a flag
+         * materialization feeding the load. */
+        p = p->rb_link[cmp > 0];
     }
     return NULL;
 }
 
+/* Batch width: enough in-flight descents to fill the memory subsystem's
+ * parallelism (~10 outstanding misses on current x86), small enough
+ * that the cursor array stays in registers/L1. */
+#define RB_FINDMANY_BATCH 8
+
+/* Looks up keys[0..n) and stores each match (or NULL) in out[].
+ * Serial rbFind calls chain one dependent cache miss per level;
+ * interleaving a batch of descents lets all of their node fetches
+ * overlap, so a batch of B lookups costs about one lookup's latency
+ * instead of B. Results are position-for-position with keys. */
+void rbFindMany(const rbTable *tree, const void **keys, size_t n, void **out) {
+    size_t base, i;
+
+    if (out == NULL) return;
+    if (tree == NULL || keys == NULL) {
+        for (i = 0; i < n; i++) out[i] = NULL;
+        return;
+    }
+
+    rb_comparison_func *compare = tree->rb_compare;
+    void *param = tree->rb_param;
+
+    for (base = 0; base < n; base += RB_FINDMANY_BATCH) {
+        const rbNode *p[RB_FINDMANY_BATCH];
+        size_t m = n - base;
+        size_t live;
+
+        if (m > RB_FINDMANY_BATCH) m = RB_FINDMANY_BATCH;
+
+        for (i = 0; i < m; i++) {
+            p[i] = keys[base + i] != NULL ? tree->rb_root : NULL;
+            out[base + i] = NULL;
+            if (p[i] != NULL)
+                __builtin_prefetch(p[i]);
+        }
+
+        /* Round-robin one level at a time: by the time cursor i's
+         * comparator runs, the node it prefetched on the previous
+         * round has had m-1 other descents' worth of work to arrive. */
+        do {
+            live = 0;
+            for (i = 0; i < m; i++) {
+                if (p[i] == NULL)
+                    continue;
+
+                int cmp = compare(keys[base + i], p[i]->rb_data, param);
+
+                if (cmp == 0) {
+                    out[base + i] = p[i]->rb_data;
+                    p[i] = NULL;
+                    continue;
+                }
+                p[i] = p[i]->rb_link[cmp > 0];
+                if (p[i] != NULL) {
+                    __builtin_prefetch(p[i]);
+                    live++;
+                }
+            }
+        } while (live > 0);
+    }
+}
+
 /* Initializes trav for use with tree
  * and selects the null node. */
 void rbIterInit(rbIter *trav, rbTable *tree) {
@@ -480,17 +659,22 @@ void *rbIterFind(rbIter *trav, rbTable *tree, void *item) {
     trav->rb_height = 0;
     trav->rb_generation = tree->rb_generation;
 
+    rb_comparison_func *compare = tree->rb_compare;
+    void *param = tree->rb_param;
+
     for (p = tree->rb_root; p != NULL; p = q) {
-        int cmp = tree->rb_compare(item, p->rb_data, tree->rb_param);
+        /* Same child prefetch as rbFind; see the comment there. */
+        __builtin_prefetch(p->rb_link[0]);
+        __builtin_prefetch(p->rb_link[1]);
+
+        int cmp = compare(item, p->rb_data, param);
 
-        if (cmp < 0)
-            q = p->rb_link[0];
-        else if (cmp > 0)
-            q = p->rb_link[1];
-        else {
+        if (cmp == 0) {
             trav->rb_node = p;
             return p->rb_data;
         }
+        /* Same branchless child select as rbFind. */
+        q = p->rb_link[cmp > 0];
         assert(trav->rb_height < RB_MAX_HEIGHT);
         trav->rb_stack[trav->rb_height++] = p;
     }
@@ -543,7 +727,12 @@ void *rbIterCopy(rbIter *trav, const rbIter *src) {
 }
 
 /* Refreshes the stack of parent pointers in |trav|
-   and updates its generation number. */
+   and updates its generation number.
+   The rebuild is comparator-driven: without per-node parent links the
+   only way back to |rb_node| is to re-descend from the root, which also
+   means the comparator must still agree with the tree order when this
+   runs. That holds here — ws_cookie's keys are immutable while in a
+   table — and it is the documented libavl contract for this variant. */
 static void trav_refresh(rbIter *trav) {
     assert(trav != NULL);
 
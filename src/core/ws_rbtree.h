@@ -32,39 +32,92 @@
 #define __RBTREE_H__
 
 #include <stddef.h>
+#include <ws_malloc.h>
 
-/* Function types. */
+/* Function types.
+ * The comparator stays a plain function pointer rather than a macro-
+ * generated family of type-specialized tables (rbCreateInt64 etc.):
+ * both in-tree consumers key on strings, where strcmp/ws_strcasecmp
+ * dominates the indirect-call overhead such specialization removes.
+ * Revisit if an integer-keyed table ever shows up in a profile. */
 typedef int rb_comparison_func(const void *rb_a, const void *rb_b, void *rb_param);
 typedef void rb_item_func(void *rb_item, void *rb_param);
 typedef void *rb_copy_func(void *rb_item, void *rb_param);
 
-/* Maximum RB height. */
+/* Maximum RB height. A 128-deep red-black tree would hold ~2^64 nodes,
+ * so this bound is unreachable in practice. The insert/delete fix-ups
+ * record their path in stacks of this depth instead of storing a parent
+ * pointer per node: the stack costs ~1KB of cold stack for the duration
+ * of one call, while parent pointers would grow every node by 8 bytes
+ * permanently and add a third link to update in every rotation. */
 #ifndef RB_MAX_HEIGHT
 #define RB_MAX_HEIGHT 128
 #endif
 
-/* Tree data structure. */
+/* Tree data structure.
+ * Nodes are carved from |rb_node_arena| in page-sized chunks instead of
+ * one zmalloc per insert: no per-node allocator header (a 16-byte tax on
+ * a 32-byte node), neighbouring nodes share pages, and rbDestroy returns
+ * whole chunks instead of walking a free() per node. Deleted nodes are
+ * threaded onto |rb_free_list| (through rb_link[0]) for reuse.
+ *
+ * There is deliberately no "small tree" mode that keeps the first ~32
+ * items in a flat sorted array: rbProbe hands out stable |void **|
+ * slots into node storage (rbIterInsert recovers the node from that
+ * address) and a memmove-shuffled array would invalidate them on the
+ * next insert. The slab gets most of the locality benefit anyway — a
+ * tiny tree's nodes sit consecutively in one 4KB chunk.
+ *
+ * The three fields every descent reads — root, comparator, param —
+ * lead the struct so one cache line serves a lookup's prologue (the
+ * loops then keep them in locals and never reread through |tree|).
+ * No _Alignas(64) on top of that: tables come from zmalloc, which
+ * guarantees only malloc alignment, and an over-aligned type the
+ * allocator cannot honor is undefined behavior, not a speedup. */
 typedef struct rbTable {
     struct rbNode *rb_root;            /* Tree's root. */
     rb_comparison_func *rb_compare;    /* Comparison function. */
     void *rb_param;                    /* Extra argument to |rb_compare|. */
     size_t rb_count;                   /* Number of items in tree. */
     unsigned long rb_generation;       /* Generation number. */
+    ws_arena rb_node_arena;            /* Slab backing all nodes. */
+    struct rbNode *rb_free_list;       /* Deleted nodes awaiting reuse. */
 } rbTable;
 
-/* Color of a red-black node. */
+/* Color of a red-black node. Stored as a plain byte rather than stolen
+ * from a child pointer's low bit: tagging would shrink the node from 32
+ * to 24 bytes, but every link read/write in the balancing code would go
+ * through mask-and-cast accessors, diverging this file from its libavl
+ * ancestry for one-third of a cache line. Node locality is handled by
+ * the per-table slab instead, which keeps neighbouring nodes on the
+ * same pages without touching the algorithm. */
 enum rbColor {
     RB_BLACK,   /* Black. */
     RB_RED      /* Red. */
 };
 
-/* A red-black tree node. */
+/* A red-black tree node.
+ *
+ * Nodes deliberately point at user data through |rb_data| rather than
+ * being embedded in it (Linux-kernel "intrusive" style). The extra
+ * dereference per level costs a cache line, but it is what lets one
+ * item live in several tables at once and keeps the comparator working
+ * on plain user structs — ws_cookie keys the same items into nested
+ * domain/path tables through this API. Callers that need the owning
+ * node of a probed slot already get it from the |rb_data| address, as
+ * rbIterInsert does with offsetof. */
 typedef struct rbNode {
     struct rbNode *rb_link[2];  /* Subtrees. */
     void *rb_data;              /* Pointer to data. */
     unsigned char rb_color;     /* Color. */
 } rbNode;
 
+/* The embedded stack makes sizeof(rbIter) ~1KB, which looks heavy but is
+ * the right trade for how iterators are used here: ws_cookie declares
+ * them as short-lived locals, so the storage is a stack-pointer bump and
+ * only the first rb_height slots are ever touched (rbIterCopy likewise
+ * copies just the live entries). A lazily-grown heap stack would swap
+ * that for a zmalloc/zfree pair per traversal. */
 typedef struct rbIter {
     rbTable *rb_table;                  /* Tree being traversed. */
     rbNode *rb_node;                    /* Current node in tree. */
@@ -76,12 +129,14 @@ typedef struct rbIter {
 
 /* Table functions. */
 rbTable *rbCreate(rb_comparison_func *compare, void *param);
+rbTable *rbBuildSorted(void **items, size_t n, rb_comparison_func *compare, void *param);
 void rbDestroy(rbTable *tree, rb_item_func *destroy);
 void **rbProbe(rbTable *tree, void *item);
 void *rbInsert(rbTable *tree, void *item);
 void *rbReplace(rbTable *tree, void *item);
 void *rbDelete(rbTable *tree, const void *item);
 void *rbFind(const rbTable *tree, const void *item);
+void rbFindMany(const rbTable *tree, const void **keys, size_t n, void **out);
 /* Table traverser functions. */
 void rbIterInit(rbIter *trav, rbTable *tree);
 void *rbIterFirst(rbIter *trav, rbTable *tree);
@@ -28,21 +28,99 @@
 #include <string.h>
 #include <ws_ssl.h>
 #include <ws_log.h>
+#include <ws_malloc.h>
+#include <ws_rbtree.h>
+#include <ws_util.h>
+
+/* Formats the earliest queued OpenSSL error into a caller-visible
+ * string. ERR_error_string_n writes into our own buffer instead of
+ * ERR_error_string's NULL-buffer variant, whose internal static is not
+ * re-entrant. Only ever evaluated inside a ws_log_* argument list, so
+ * the level gate in the log macro already keeps the ~16KB error-table
+ * lookup off suppressed paths during TLS failure storms; single loop
+ * thread makes the static buffer safe. */
+static const char *ws_ssl_errstr(void) {
+    static char ebuf[256];
+    ERR_error_string_n(ERR_get_error(), ebuf, sizeof(ebuf));
+    return ebuf;
+}
+
+/* Process-wide client context: the header already promises "an
+ * application only needs one client SSL_CTX instance to reuse", so
+ * repeated ws_ssl_client_ctx_new calls now hand back the same
+ * (refcounted) context instead of building a fresh one — fresh
+ * contexts would each start with an empty session cache and every
+ * handshake would be a full one. Loop thread only, like the rest of
+ * the scanner. */
+static SSL_CTX *s_client_ctx = NULL;
+
+/* Most recent resumable session per hostname, keyed case-insensitively.
+ * Entries own their session reference; hostname strings live in the
+ * arena and are reused when a host's session is refreshed. */
+typedef struct ws_ssl_host_session {
+    char *host;
+    SSL_SESSION *sess;
+} ws_ssl_host_session;
+
+static rbTable *s_session_map = NULL;
+static ws_arena s_session_arena;
+
+static int ws_ssl_host_session_cmp(const void *a, const void *b, void *param) {
+    (void)param;
+    return ws_strcasecmp(((const ws_ssl_host_session *)a)->host,
+                         ((const ws_ssl_host_session *)b)->host);
+}
+
+static void ws_ssl_host_session_free(void *item, void *param) {
+    (void)param;
+    SSL_SESSION_free(((ws_ssl_host_session *)item)->sess);
+}
+
+/* Invoked by OpenSSL whenever a connection yields a resumable session
+ * (for TLS 1.3 that is per NewSessionTicket, after the handshake).
+ * Stores it under the connection's SNI name, replacing any older
+ * session for that host. Returning 1 keeps our reference. */
+static int ws_ssl_new_session_cb(SSL *ssl, SSL_SESSION *sess) {
+    const char *host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+
+    if (!host || !*host || !s_session_map) return 0;
+
+    ws_ssl_host_session key = { .host = (char *)host };
+    ws_ssl_host_session *entry = rbFind(s_session_map, &key);
+    if (entry) {
+        SSL_SESSION_free(entry->sess);
+        entry->sess = sess;
+        return 1;
+    }
+
+    entry = ws_arena_alloc(&s_session_arena, sizeof(*entry));
+    entry->host = ws_arena_strdup(&s_session_arena, host);
+    entry->sess = sess;
+    if (!rbProbe(s_session_map, entry)) {
+        entry->sess = NULL;
+        return 0;
+    }
+    return 1;
+}
 
 /**
  * @brief Initializes the OpenSSL library.
  */
 int ws_ssl_init_libs(void) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    /* 1.1.0+ initializes itself on first use; one explicit call that
+     * also loads the error strings replaces the legacy sequence below,
+     * whose calls are deprecated shims on 3.0 that drag in every
+     * algorithm table whether needed or not. */
+    OPENSSL_init_ssl(OPENSSL_INIT_LOAD_SSL_STRINGS |
+                     OPENSSL_INIT_LOAD_CRYPTO_STRINGS, NULL);
+#else
     // Register all OpenSSL algorithms and load error strings
-    // OpenSSL 1.1.0+ simplifies initialization; these functions are
-    // old version macros or no longer strictly required.
-    // For compatibility, retaining these calls is harmless.
-    SSL_library_init(); // Or OPENSSL_init_ssl() for OpenSSL 1.1.0+
+    SSL_library_init();
     SSL_load_error_strings();
-#if OPENSSL_VERSION_NUMBER < 0x30000000L
     ERR_load_BIO_strings();
+    OpenSSL_add_all_algorithms();
 #endif
-    OpenSSL_add_all_algorithms(); // Or EVP_add_all_algorithms() for OpenSSL 1.1.0+
 
     ws_log_info("OpenSSL libraries initialized.");
     return 0;
@@ -52,12 +130,23 @@ int ws_ssl_init_libs(void) {
  * @brief Cleans up OpenSSL library resources.
  */
 void ws_ssl_cleanup_libs(void) {
+    // Drop the cached sessions and the module's context reference first
+    if (s_session_map) {
+        rbDestroy(s_session_map, ws_ssl_host_session_free);
+        s_session_map = NULL;
+        ws_arena_release(&s_session_arena);
+    }
+    if (s_client_ctx) {
+        SSL_CTX_free(s_client_ctx);
+        s_client_ctx = NULL;
+    }
     // Clean up OpenSSL resources
+    // In OpenSSL 1.1.0+ cleanup runs automatically at exit (or via
+    // OPENSSL_cleanup()); the explicit calls are deprecated no-ops.
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
     EVP_cleanup();
     ERR_free_strings();
     // Conf_modules_free() and CRYPTO_cleanup_all_ex_data() are also part of cleanup
-    // In OpenSSL 1.1.0+, most cleanup is handled by OPENSSL_cleanup()
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
     CRYPTO_cleanup_all_ex_data();
     ERR_remove_state(0);
 #endif
@@ -68,17 +157,82 @@ void ws_ssl_cleanup_libs(void) {
  * @brief Creates a new SSL context for client connections.
  */
 SSL_CTX *ws_ssl_client_ctx_new(void) {
+    if (s_client_ctx) {
+        SSL_CTX_up_ref(s_client_ctx);
+        return s_client_ctx;
+    }
+
     // Use TLSv1.2/1.3 negotiation method, or TLS_client_method() for broader compatibility
     const SSL_METHOD *method = TLS_client_method(); // Recommended for OpenSSL 1.1.0+
 
     SSL_CTX *ctx = SSL_CTX_new(method);
     if (!ctx) {
-        ws_log_error("Failed to create SSL_CTX: %s", ERR_error_string(ERR_get_error(), NULL));
+        ws_log_error("Failed to create SSL_CTX: %s", ws_ssl_errstr());
         return NULL;
     }
 
     // Disable insecure protocol versions (e.g., SSLv2, SSLv3)
     SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION); // Enforce minimum TLS 1.2
+
+    /* Steer negotiation to hardware-accelerated AEAD suites: AES-GCM
+     * rides AES-NI/PCLMUL and ChaCha20-Poly1305 covers CPUs without
+     * AES units, while CBC+HMAC suites — an order of magnitude slower
+     * per byte and the source of padding-oracle history — drop out of
+     * the TLS 1.2 offer entirely. Bulk download throughput after the
+     * handshake is symmetric-cipher-bound, so this is where HTTPS
+     * crawl bandwidth comes from. Failure just leaves the defaults. */
+    if (!SSL_CTX_set_cipher_list(ctx, "ECDHE+AESGCM:ECDHE+CHACHA20")) {
+        ws_log_warn("Failed to set TLS 1.2 cipher list; using defaults.");
+    }
+#if defined(TLS1_3_VERSION)
+    /* TLS 1.3 defaults are already AEAD-only; pinning the list mainly
+     * puts AES-GCM first for the AES-NI machines this runs on.
+     *
+     * No EVP_set_default_properties() call to "force" VAES/AES-NI: the
+     * default provider's AES-GCM already CPUID-dispatches at runtime to
+     * the widest implementation the host offers (AES-NI, then VAES on
+     * Ice Lake+/Zen 4+), and provider property strings select between
+     * providers, not between a provider's internal code paths — there is
+     * no "cpu.vaes" property to query. Picking GCM suites here is the
+     * whole job; OpenSSL does the per-CPU dispatch. */
+    if (!SSL_CTX_set_ciphersuites(ctx,
+            "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:"
+            "TLS_CHACHA20_POLY1305_SHA256")) {
+        ws_log_warn("Failed to set TLS 1.3 ciphersuites; using defaults.");
+    }
+#endif
+
+#if defined(SSL_OP_ENABLE_KTLS)
+    /* Let the kernel run the record-layer crypto (Linux >= 4.17 with
+     * tls.ko, OpenSSL >= 3.0): bulk AES-GCM on the response stream
+     * moves out of user space, and NICs with inline TLS offload it
+     * entirely. Purely opportunistic — when the cipher, kernel or
+     * module does not qualify, OpenSSL silently keeps the user-space
+     * path. Engine offload (QAT) is deliberately not wired up: it
+     * needs vendor drivers and ENGINE setup for hardware this scanner
+     * is not known to run on. */
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
+    /* Cache client sessions so repeat connections to the same host can
+     * offer the previous session and complete an abbreviated handshake
+     * (session ticket / ID resumption) instead of paying the full
+     * asymmetric-crypto exchange again — after the first contact, a
+     * host costs symmetric crypto and one round trip. The new-session
+     * callback files each resumable session under its SNI name;
+     * ws_ssl_new_connection_ssl installs it on the next connection.
+     * SSL_SESS_CACHE_NO_INTERNAL_STORE keeps OpenSSL from duplicating
+     * the sessions in its own internal cache. */
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT |
+                                        SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, ws_ssl_new_session_cb);
+
+    s_session_map = rbCreate(ws_ssl_host_session_cmp, NULL);
+    ws_arena_init(&s_session_arena, 4096);
+    /* The module keeps its own reference so the singleton survives any
+     * caller's ws_ssl_free_ctx; it is dropped in ws_ssl_cleanup_libs. */
+    s_client_ctx = ctx;
+    SSL_CTX_up_ref(ctx);
     // If client certificate verification of the server is required, uncomment and configure:
     // SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, NULL);
     // SSL_CTX_load_verify_locations(ctx, "path/to/ca-certificates.pem", NULL);
@@ -108,7 +262,7 @@ SSL *ws_ssl_new_connection_ssl(SSL_CTX *ctx, const char *hostname) {
 
     SSL *ssl = SSL_new(ctx);
     if (!ssl) {
-        ws_log_error("Failed to create SSL object: %s", ERR_error_string(ERR_get_error(), NULL));
+        ws_log_error("Failed to create SSL object: %s", ws_ssl_errstr());
         return NULL;
     }
 
@@ -117,11 +271,23 @@ SSL *ws_ssl_new_connection_ssl(SSL_CTX *ctx, const char *hostname) {
     if (hostname && strlen(hostname) > 0) {
         if (!SSL_set_tlsext_host_name(ssl, hostname)) {
             ws_log_error("Failed to set SNI hostname '%s': %s", hostname, 
-                        ERR_error_string(ERR_get_error(), NULL));
+                        ws_ssl_errstr());
             SSL_free(ssl);
             return NULL;
         }
         ws_log_info("SNI hostname set to: %s", hostname);
+
+        /* Offer the host's cached session so the server can grant an
+         * abbreviated handshake; SSL_set_session takes its own
+         * reference. Unknown hosts simply do a full handshake and seed
+         * the cache through the new-session callback. */
+        if (s_session_map) {
+            ws_ssl_host_session key = { .host = (char *)hostname };
+            ws_ssl_host_session *entry = rbFind(s_session_map, &key);
+            if (entry && SSL_set_session(ssl, entry->sess)) {
+                ws_log_debug("Offering cached TLS session for %s.", hostname);
+            }
+        }
     }
 
     // By default, OpenSSL clients verify the server certificate.
@@ -28,7 +28,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <libgen.h> // For dirname, basename
+#include <stdint.h>
+#include <stdbool.h>
 #include <ws_url.h>
 
 // Helper for string duplication
@@ -41,277 +42,369 @@ static char* url_safe_strdup(const char *s) {
     return dup;
 }
 
+/* Pointer+length view of one URL component. Spans point into the
+ * caller's URL string (or a static literal for defaults); nothing is
+ * allocated and nothing needs freeing. */
+typedef struct ws_url_span {
+    const char *ptr;
+    size_t len;
+} ws_url_span_t;
+
+typedef struct ws_url_parts {
+    ws_url_span_t protocol;     // Scheme without the "://"
+    ws_url_span_t hostname;     // Host without port
+    ws_url_span_t path;         // Includes the leading '/'; query/fragment excluded
+    int port;                   // 0 means default port
+} ws_url_parts_t;
+
 // 简单的 URL 解析函数，提取协议、主机、端口和路径
 // 这不是一个完整的 URL 解析器，仅用于内部辅助
-static void parse_url_parts(const char *url, char **protocol, char **hostname, int *port, char **path) {
-    *protocol = NULL;
-    *hostname = NULL;
-    *port = 0; // 0 means default port
-    *path = NULL;
-
-    char *url_copy = url_safe_strdup(url);
-    if (!url_copy) return;
-
-    char *temp = url_copy;
-    char *p_end = strstr(temp, "://");
-    if (p_end) {
-        *protocol = strndup(temp, p_end - temp);
-        temp = p_end + 3; // Skip "://"
+/* One forward pass over the URL, writing spans into the caller's stack
+ * struct. The old version strdup'ed the whole URL plus one strndup per
+ * component and this sits on the per-link hot path, so the parse itself
+ * now costs zero heap calls; callers copy only the component they keep. */
+static void parse_url_parts(const char *url, ws_url_parts_t *out) {
+    memset(out, 0, sizeof(*out));
+
+    if (!url) return;
+
+    const char *p = url;
+    const char *scheme_end = strstr(url, "://");
+    if (scheme_end) {
+        out->protocol.ptr = url;
+        out->protocol.len = (size_t)(scheme_end - url);
+        p = scheme_end + 3; // Skip "://"
     } else {
-        // No protocol, assume http or https if port is 443
-        // This is a simplification; in real world, one might default to "http"
-        // Or leave protocol as NULL and let other logic determine.
-        *protocol = url_safe_strdup("http"); // Default to http if no protocol
+        /* No protocol given; default to http as before. No separate
+         * parse_url_parts_abs specialization for callers whose inputs
+         * are known absolute: this fallback is one predictable branch
+         * (the strstr miss already paid for the scan), the function
+         * writes spans rather than allocating, and a second parser
+         * variant would be two copies of the same authority/path logic
+         * to keep in sync for a branch the predictor never misses. */
+        out->protocol.ptr = "http";
+        out->protocol.len = 4;
     }
 
-    char *host_end = strchr(temp, '/');
-    char *port_sep = strchr(temp, ':');
-    char *query_sep = strchr(temp, '?');
-    char *fragment_sep = strchr(temp, '#');
-
-    char *effective_end = NULL;
-    if (host_end) effective_end = host_end;
-    if (port_sep && (effective_end == NULL || port_sep < effective_end)) effective_end = port_sep;
-    if (query_sep && (effective_end == NULL || query_sep < effective_end)) effective_end = query_sep;
-    if (fragment_sep && (effective_end == NULL || fragment_sep < effective_end)) effective_end = fragment_sep;
-
-    if (effective_end) {
-        *hostname = strndup(temp, effective_end - temp);
-    } else {
-        *hostname = url_safe_strdup(temp);
+    /* Authority: ends at the first '/', '?' or '#'; an optional ':' inside
+     * it separates the port. The delimiter scans go through strcspn
+     * rather than a byte-at-a-time multi-compare loop: glibc's strcspn
+     * builds a 256-entry membership table from the reject set and then
+     * walks the string with SSE/AVX compares, so all four delimiters are
+     * tested per 16/32-byte load in one pass — the tokenizing win of a
+     * hand-written intrinsic scanner without carrying per-ISA code or a
+     * scalar tail here. It also subsumes a file-local delimiter
+     * classification table (bits for '/', ':', '?', '#'): such a table
+     * caps the loop at one byte per lookup, while strcspn's internal
+     * table feeds block compares — so a hand-rolled url_cls[256] would
+     * be strictly slower than what runs now. ws_url_is_valid keeps its
+     * own uri_char_map because its predicate (full RFC 3986 membership)
+     * is not expressible as a strcspn reject set. strcspn is preferred
+     * over the equivalent strpbrk for the same scan because it returns
+     * a length directly — the span arithmetic needs exactly that, and
+     * there is no NULL-versus-end-of-string result to branch on; glibc
+     * implements both on the same vectorized core. */
+    const char *host_start = p;
+    const char *colon = NULL;
+
+    out->hostname.ptr = host_start;
+    out->hostname.len = strcspn(host_start, ":/?#");
+    p = host_start + out->hostname.len;
+
+    if (*p == ':') {
+        colon = p;
+        p = colon + 1 + strcspn(colon + 1, "/?#");
     }
 
-    if (port_sep && (port_sep < (host_end ? host_end : (char*)(size_t)-1))) {
-        // Port specified
-        char *port_str_start = port_sep + 1;
-        char *port_str_end = (host_end && host_end < query_sep ? host_end : query_sep);
-        if (!port_str_end && fragment_sep && fragment_sep > port_sep) port_str_end = fragment_sep;
-        if (!port_str_end) port_str_end = temp + strlen(temp);
-
-        char *port_val_str = strndup(port_str_start, port_str_end - port_str_start);
-        if (port_val_str) {
-            *port = atoi(port_val_str);
-            free(port_val_str);
+    /* Digits accumulate straight off the span — no strndup/atoi round
+     * trip — with a running bound check so a junk run of digits cannot
+     * overflow the accumulator: anything past 65535 resolves to 0
+     * ("default port"), matching how an absent port is treated. */
+    if (colon) {
+        int port = 0;
+        for (const char *q = colon + 1; q < p && *q >= '0' && *q <= '9'; q++) {
+            port = port * 10 + (*q - '0');
+            if (port > 65535) {
+                port = 0;
+                break;
+            }
         }
+        out->port = port;
     }
 
-    if (host_end) {
-        // Path starts after hostname
-        char *path_start = host_end;
-        char *path_end = (query_sep && query_sep < fragment_sep ? query_sep : fragment_sep);
-        if (!path_end) path_end = temp + strlen(temp);
-        if (path_end) {
-            *path = strndup(path_start, path_end - path_start);
-        } else {
-            *path = url_safe_strdup(path_start);
-        }
+    if (*p == '/') {
+        out->path.ptr = p;
+        out->path.len = strcspn(p, "?#");
     } else {
-        *path = url_safe_strdup("/"); // Default path if no slash
+        out->path.ptr = "/"; // Default path if no slash
+        out->path.len = 1;
+    }
+}
+
+/* Copies a span out as a NUL-terminated heap string (the public API
+ * returns owned strings). The span length is exact, so this is a plain
+ * malloc+memcpy; strndup would rescan the bytes with strnlen looking
+ * for a NUL that spans into a larger URL do not carry. */
+static char *ws_url_span_dup(ws_url_span_t span) {
+    if (!span.ptr) return NULL;
+    char *dup = malloc(span.len + 1);
+    if (!dup) {
+        perror("malloc failed in ws_url_span_dup");
+        return NULL;
     }
+    memcpy(dup, span.ptr, span.len);
+    dup[span.len] = '\0';
+    return dup;
+}
 
-    free(url_copy);
+/* Scheme tests as packed-integer compares: "http" resolves with one
+ * 32-bit load against a constant and "https" adds a fifth-byte check,
+ * instead of a libc strcmp call per request. The spans are not
+ * NUL-terminated, so the bytes go through memcpy (which the compiler
+ * folds into a plain unaligned load). */
+static bool ws_url_span_is_http(ws_url_span_t span) {
+    uint32_t v, http;
+    if (span.len != 4 || !span.ptr) return false;
+    memcpy(&v, span.ptr, 4);
+    memcpy(&http, "http", 4);
+    return v == http;
 }
 
+static bool ws_url_span_is_https(ws_url_span_t span) {
+    uint32_t v, http;
+    if (span.len != 5 || !span.ptr) return false;
+    memcpy(&v, span.ptr, 4);
+    memcpy(&http, "http", 4);
+    return v == http && span.ptr[4] == 's';
+}
+
+/* Writes v in decimal into out (no NUL) and returns the digit count.
+ * Ports are at most five digits, so this replaces snprintf — whose
+ * cost is dominated by parsing the format string, not producing the
+ * digits — with a dozen arithmetic instructions. */
+static int ws_utoa(unsigned v, char *out) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+/* Default port for a scheme span, or 0 for schemes without one. Rides
+ * the packed compares above, so resolving a default costs two
+ * register-width tests rather than a strcmp chain, and new schemes get
+ * added in exactly one place. */
+static int ws_url_span_default_port(ws_url_span_t scheme) {
+    if (ws_url_span_is_http(scheme)) return 80;
+    if (ws_url_span_is_https(scheme)) return 443;
+    return 0;
+}
+
+/* Bytes allowed in a request URL per RFC 3986: unreserved, gen-delims,
+ * sub-delims and '%'. Control bytes, space, '"', '<', '>', '\', '^',
+ * '`', '{', '|', '}' and anything non-ASCII stay zero. */
+static const unsigned char uri_char_map[256] = {
+    ['a' ... 'z'] = 1, ['A' ... 'Z'] = 1, ['0' ... '9'] = 1,
+    ['-'] = 1, ['.'] = 1, ['_'] = 1, ['~'] = 1,
+    [':'] = 1, ['/'] = 1, ['?'] = 1, ['#'] = 1,
+    ['['] = 1, [']'] = 1, ['@'] = 1,
+    ['!'] = 1, ['$'] = 1, ['&'] = 1, ['\''] = 1,
+    ['('] = 1, [')'] = 1, ['*'] = 1, ['+'] = 1,
+    [','] = 1, [';'] = 1, ['='] = 1, ['%'] = 1,
+};
+
+bool ws_url_is_valid(const char *url) {
+    if (!url || !*url) return false;
+
+    for (const unsigned char *p = (const unsigned char *)url; *p; p++) {
+        if (!uri_char_map[*p]) return false;
+    }
+    return true;
+}
+
+/* No per-authority result cache in front of this or ws_url_get_hostname:
+ * nothing in the tree calls either on a per-request hot path (crawl
+ * scope checks go through ws_url_is_valid only), the parse behind them
+ * is a single zero-allocation pass, and the contract returns an owned
+ * string — so a cache hit would still strdup, leaving only the dot-scan
+ * saved while adding a table, an eviction policy and staleness to
+ * reason about. Revisit if a caller ever resolves FLDs per link. */
 char* ws_url_get_fld(const char *url) {
-    char *protocol = NULL;
-    char *hostname = NULL;
-    int port;
-    char *path = NULL;
-    parse_url_parts(url, &protocol, &hostname, &port, &path);
-
-    char *fld = NULL;
-    if (hostname) {
-        // Simple FLD extraction: find last two dots
-        // This is a naive approach and is NOT robust for all TLDs (e.g., .co.uk)
-        // A proper FLD requires a Public Suffix List.
-        char *dot1 = strrchr(hostname, '.');
-        if (dot1) {
-            char *dot2 = strrchr(hostname, '.'); // find second last dot
-            if (dot2 && dot2 != dot1) {
-                char *temp = dot2;
-                // Move back to find the start of the "domain.tld" part
-                int count = 0;
-                while(temp > hostname && *temp == '.') { // Handle multiple dots like .com.cn
-                    temp--;
-                    count++;
-                    if (count > 1) break; // Simplified: only look for .tld or .sub.tld
-                }
-                if (count > 1 && temp > hostname && *temp != '.') { // Found a second dot, potentially a real domain
-                    char *start = strrchr(hostname, '.'); // First dot from right
-                    if (start) {
-                        char *second_start = strrchr(hostname, '.');
-                        if (second_start && second_start != start) { // Has at least two dots
-                            // Handle cases like .co.uk. For simplicity, just get everything after the first dot from right
-                            // For www.google.com, start points to .com. We need google.com
-                            // For news.bbc.co.uk, start points to .uk. We need bbc.co.uk
-                            // A proper check needs a public suffix list.
-                            // For now, let's just grab the last two segments if available.
-                            char *first_dot = strchr(hostname, '.'); // First dot from left
-                            char *last_dot = strrchr(hostname, '.'); // Last dot from right
-                            if (first_dot && last_dot && first_dot != last_dot) {
-                                // If there are multiple dots, take the part after the first dot from the end.
-                                // e.g., "www.google.com" -> "google.com"
-                                // e.g., "sub.domain.co.uk" -> "co.uk" (incorrect for this naive approach)
-                                // e.g., "sub.domain.com" -> "domain.com"
-                                char *fld_start = last_dot; // start from .tld
-                                // Move back to find the start of the domain part
-                                while(fld_start > hostname && *(fld_start - 1) != '.') {
-                                    fld_start--;
-                                }
-                                fld = url_safe_strdup(fld_start);
-                            } else {
-                                // If only one dot (e.g. "localhost.com") or no dots ("localhost")
-                                fld = url_safe_strdup(hostname);
-                            }
-                        } else { // Only one dot like "example.com"
-                            char *start = strrchr(hostname, '.');
-                            if (start) {
-                                while(start > hostname && *(start-1) != '.') start--;
-                                fld = url_safe_strdup(start);
-                            } else { // No dot, like "localhost"
-                                fld = url_safe_strdup(hostname);
-                            }
-                        }
-                    } else { // No dot, like "localhost"
-                         fld = url_safe_strdup(hostname);
-                    }
-                } else { // Only one dot
-                    char *start = strrchr(hostname, '.');
-                    if (start) {
-                        while(start > hostname && *(start-1) != '.') start--;
-                        fld = url_safe_strdup(start);
-                    } else { // No dot
-                        fld = url_safe_strdup(hostname);
-                    }
-                }
-            } else { // Only one dot, or no dots
-                fld = url_safe_strdup(hostname);
+    ws_url_parts_t parts;
+    parse_url_parts(url, &parts);
+
+    if (!parts.hostname.ptr || parts.hostname.len == 0) return NULL;
+
+    /* Simple FLD extraction: keep the last two dot-separated labels.
+     * This is a naive approach and is NOT robust for all TLDs (e.g.
+     * "sub.domain.co.uk" yields "co.uk"); a proper FLD requires a
+     * Public Suffix List. Deliberately not fixed here: a real PSL
+     * means either linking libpsl (a new runtime dependency) or
+     * generating a reversed-label trie from public_suffix_list.dat at
+     * build time (a data file plus generator this project does not
+     * ship), and no caller currently makes scope or dedup decisions
+     * off this value. If one ever does, libpsl is the cheaper of the
+     * two routes to correctness. Note that a ".com/.org/.net fast
+     * path" in front of a PSL lookup buys nothing here: with no slow
+     * path behind it, the generic last-two-labels scan below already
+     * is the fast path — and it is exactly correct for those TLDs. */
+    /* One right-to-left pass recording the last two dots: the FLD
+     * starts one byte after the second-to-last dot, or at the start of
+     * the host when there are fewer than two labels above it. */
+    const char *host = parts.hostname.ptr;
+    const char *end = host + parts.hostname.len;
+    const char *last_dot = NULL, *prev_dot = NULL;
+    for (const char *p = end; p > host; ) {
+        if (*--p == '.') {
+            if (!last_dot) {
+                last_dot = p;
+            } else {
+                prev_dot = p;
+                break;
             }
-        } else { // No dots at all (e.g. "localhost")
-            fld = url_safe_strdup(hostname);
         }
     }
+    if (!last_dot) {
+        // No dots at all (e.g. "localhost")
+        return ws_url_span_dup(parts.hostname);
+    }
 
-    free(protocol);
-    free(hostname);
-    free(path);
-    return fld;
+    const char *fld_start = prev_dot ? prev_dot + 1 : host;
+    ws_url_span_t fld = { fld_start, (size_t)(end - fld_start) };
+    return ws_url_span_dup(fld);
 }
 
 
-char* ws_url_get_hostname(const char *url) {
-    char *protocol = NULL;
-    char *hostname = NULL;
-    int port;
-    char *path = NULL;
-    parse_url_parts(url, &protocol, &hostname, &port, &path);
+/* Zero-copy variant: hands back a pointer+length into the caller's URL
+ * buffer. Callers that only compare or hash the hostname skip the
+ * allocation the owning variant below pays. */
+int ws_url_hostname_view(const char *url, const char **out, size_t *outlen) {
+    ws_url_parts_t parts;
+    parse_url_parts(url, &parts);
+
+    if (!parts.hostname.ptr || parts.hostname.len == 0) return -1;
+    *out = parts.hostname.ptr;
+    *outlen = parts.hostname.len;
+    return 0;
+}
 
-    // Free parsed parts not needed for return
-    free(protocol);
-    free(path);
+char* ws_url_get_hostname(const char *url) {
+    const char *host;
+    size_t len;
 
-    return hostname; // This is the hostname
+    if (ws_url_hostname_view(url, &host, &len) != 0) return NULL;
+    return ws_url_span_dup((ws_url_span_t){ host, len });
 }
 
 // 简化的 URL 路径拼接
 char* ws_url_resolve(const char *base_url, const char *relative_url) {
     if (!base_url || !relative_url) return NULL;
 
-    // 如果 relative_url 是绝对路径，直接返回其副本
-    if (strstr(relative_url, "://") != NULL || strncmp(relative_url, "//", 2) == 0) {
+    /* 如果 relative_url 是绝对路径，直接返回其副本. Scheme detection is
+     * strchr for the first ':' plus a two-byte look at what follows,
+     * not strstr("://"): strchr is a single-needle vector scan with
+     * none of strstr's substring machinery, and a scheme can only sit
+     * before the first colon anyway — "a:b://c" has no scheme, which
+     * the strstr form got wrong. */
+    const char *colon = strchr(relative_url, ':');
+    if ((colon && colon[1] == '/' && colon[2] == '/') ||
+        (relative_url[0] == '/' && relative_url[1] == '/')) {
         return url_safe_strdup(relative_url);
     }
 
-    char *base_copy = url_safe_strdup(base_url);
-    if (!base_copy) return NULL;
+    ws_url_parts_t parts;
+    parse_url_parts(base_url, &parts);
 
-    char *protocol = NULL;
-    char *hostname = NULL;
-    int port;
-    char *path = NULL;
-    parse_url_parts(base_copy, &protocol, &hostname, &port, &path);
-
-    if (!protocol || !hostname) {
-        free(base_copy);
-        free(protocol); free(hostname); free(path);
-        return NULL;
-    }
-
-    // 确定基础路径
-    char *base_path_temp = url_safe_strdup(path);
-    if (!base_path_temp) {
-        free(base_copy);
-        free(protocol); free(hostname); free(path);
+    if (!parts.protocol.ptr || !parts.hostname.ptr || parts.hostname.len == 0) {
         return NULL;
     }
 
-    char *resolved_path = NULL;
+    /* Work out the resolved path as spans and lengths only; the bytes
+     * are copied straight into the final URL buffer below, so no
+     * intermediate path string is ever allocated and freed. (A bump
+     * arena for such temporaries was considered, but a function with
+     * zero temporaries does not need one.) */
+    size_t rel_len = strlen(relative_url);
+    const char *dir_ptr = NULL;     // NULL: relative_url is the whole path
+    size_t dir_len = 0;
+    size_t resolved_path_len;
     if (relative_url[0] == '/') {
         // 相对 URL 以 / 开始，表示根路径下的绝对路径
-        resolved_path = url_safe_strdup(relative_url);
+        resolved_path_len = rel_len;
     } else {
-        // 相对路径，相对于当前目录
-        char *dir_name = dirname(base_path_temp); // dirname 会修改其参数
-        size_t dir_len = strlen(dir_name);
-        size_t rel_len = strlen(relative_url);
-        size_t total_len = dir_len + 1 + rel_len + 1; // +1 for slash, +1 for null terminator
-        resolved_path = (char*)malloc(total_len);
-        if (!resolved_path) {
-            perror("malloc failed for resolved_path");
-            free(base_path_temp);
-            free(protocol); free(hostname); free(path);
-            return NULL;
-        }
-        snprintf(resolved_path, total_len, "%s/%s", dir_name, relative_url);
+        /* 相对路径，相对于当前目录. The base directory is the path span
+         * truncated after its last '/' — computed directly on the span
+         * instead of calling dirname(), which mutates its argument and
+         * forced a writable strdup of the path just to throw it away.
+         * The truncation mirrors dirname()'s semantics (strip trailing
+         * slashes, drop the final label, strip the separator, never
+         * shorter than "/") so the joined results are unchanged. */
+        dir_ptr = parts.path.ptr;
+        dir_len = parts.path.len;
+        while (dir_len > 1 && dir_ptr[dir_len - 1] == '/') dir_len--;
+        while (dir_len > 0 && dir_ptr[dir_len - 1] != '/') dir_len--;
+        while (dir_len > 1 && dir_ptr[dir_len - 1] == '/') dir_len--;
+
+        resolved_path_len = dir_len + 1 + rel_len;
     }
 
     // 重新构建完整 URL
-    size_t result_len = 0;
-    char *resolved_url = NULL;
+    bool default_port = (parts.port == 0) ||
+                        (parts.port == ws_url_span_default_port(parts.protocol));
+
+    /* Format the port once into a stack buffer; its length feeds the
+     * size computation and its bytes feed the copy below. ws_utoa
+     * instead of snprintf: no format-string parse for a five-digit
+     * integer. Every other component length is already known from the
+     * parse (spans carry their lengths; relative_url was measured once
+     * above), so nothing is strlen'ed for sizing and then walked again
+     * by a strcpy — the URL is assembled with exactly one scan per
+     * piece. */
+    char port_buf[12];
+    size_t port_len = 0;
+    if (!default_port) {
+        port_buf[0] = ':';
+        port_len = 1 + (size_t)ws_utoa((unsigned)parts.port, port_buf + 1);
+    }
 
     // 计算长度
-    result_len += strlen(protocol);
+    size_t result_len = parts.protocol.len;
     result_len += 3; // "://"
-    result_len += strlen(hostname);
-    if (port != 0 &&
-        !((strcmp(protocol, "http") == 0 && port == 80) ||
-          (strcmp(protocol, "https") == 0 && port == 443))) {
-        result_len += 1; // ":"
-        result_len += snprintf(NULL, 0, "%d", port); // Port number length
-    }
-    result_len += strlen(resolved_path);
+    result_len += parts.hostname.len;
+    result_len += port_len;
+    result_len += resolved_path_len;
     result_len += 1; // Null terminator
 
-    resolved_url = (char*)malloc(result_len);
+    char *resolved_url = (char*)malloc(result_len);
     if (!resolved_url) {
         perror("malloc failed for resolved_url");
-        free(resolved_path);
-        free(base_path_temp);
-        free(protocol); free(hostname); free(path);
         return NULL;
     }
 
     char *current_pos = resolved_url;
-    strcpy(current_pos, protocol);
-    current_pos += strlen(protocol);
-    strcpy(current_pos, "://");
+    memcpy(current_pos, parts.protocol.ptr, parts.protocol.len);
+    current_pos += parts.protocol.len;
+    memcpy(current_pos, "://", 3);
     current_pos += 3;
-    strcpy(current_pos, hostname);
-    current_pos += strlen(hostname);
+    memcpy(current_pos, parts.hostname.ptr, parts.hostname.len);
+    current_pos += parts.hostname.len;
 
-    if (port != 0 &&
-        !((strcmp(protocol, "http") == 0 && port == 80) ||
-          (strcmp(protocol, "https") == 0 && port == 443))) {
-        current_pos += snprintf(current_pos, resolved_url + result_len - current_pos, ":%d", port);
+    if (port_len) {
+        memcpy(current_pos, port_buf, port_len);
+        current_pos += port_len;
+    }
+    /* Path: either the caller's root-relative URL verbatim, or the base
+     * directory joined as "dir" "/" "rel"; two memcpys instead of
+     * snprintf's format-string walk on the per-link path. */
+    if (dir_ptr) {
+        memcpy(current_pos, dir_ptr, dir_len);
+        current_pos[dir_len] = '/';
+        current_pos += dir_len + 1;
     }
-    strcpy(current_pos, resolved_path);
-
-    free(base_copy); // dirname might modify it, so free original copy
-    free(protocol);
-    free(hostname);
-    free(path); // Original path
-    free(base_path_temp); // dirname temp
-    free(resolved_path);
+    memcpy(current_pos, relative_url, rel_len + 1); // +1 copies the NUL
 
     return resolved_url;
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #define __WS_URL_H__
 
 #include <stddef.h> // For size_t
+#include <stdbool.h>
 
 // 函数声明
 /**
@@ -50,6 +51,18 @@ char* ws_url_get_fld(const char *url);
  */
 char* ws_url_get_hostname(const char *url);
 
+/**
+ * @brief 以零拷贝视图的形式返回 URL 中的主机名。
+ * @param url 要解析的 URL 字符串。
+ * @param out 输出: 指向 url 内部主机名起始位置的指针。
+ * @param outlen 输出: 主机名的字节长度。
+ * @return 成功返回 0, 无法解析出主机名返回 -1。
+ * @note 视图直接指向调用者的 url 缓冲区, 不分配内存, 也不以 NUL 结尾;
+ * 仅在 url 本身有效期间可用。只需比较或哈希主机名的调用者应使用本函数,
+ * 需要持有副本时再用 ws_url_get_hostname()。
+ */
+int ws_url_hostname_view(const char *url, const char **out, size_t *outlen);
+
 /**
  * @brief 尝试将相对 URL 转换为绝对 URL。
  * @param base_url 基础 URL，用于解析相对 URL。
@@ -60,4 +73,14 @@ char* ws_url_get_hostname(const char *url);
  */
 char* ws_url_resolve(const char *base_url, const char *relative_url);
 
+/**
+ * @brief 校验 URL 是否只包含 RFC 3986 允许的字符。
+ * @param url 要校验的 URL 字符串。
+ * @return 合法返回 true; NULL、空串或包含非法字节(空格、控制字符、
+ * 非 ASCII 等)返回 false。
+ * @note 单遍查表实现, 不做结构性解析, 仅用于在处理前廉价地拦截明显
+ * 畸形的链接。
+ */
+bool ws_url_is_valid(const char *url);
+
 #endif // WS_URL_H
\ No newline at end of file
@@ -28,44 +28,100 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <ws_util.h>
+#include <ws_malloc.h>
+
+/* Duplicate the first n bytes of s as a NUL-terminated string. For
+ * callers that already know the length (parsed spans, counted API
+ * results) this skips the strlen rescan strdup would do — strings that
+ * were just measured should not be measured again. */
+char *ws_strdup_n(const char *s, size_t n) {
+    char *d = zmalloc(n + 1);
+
+    if (!d) return NULL;
+    memcpy(d, s, n);
+    d[n] = '\0';
+    return d;
+}
+
+/* The six bytes the "C" locale's isspace() accepts. A static table
+ * instead of the libc call for the same reason as ws_lower below:
+ * isspace() resolves through the locale table pointer per byte, and
+ * header values get trimmed on every response. */
+static const unsigned char ws_is_space[256] = {
+    [' '] = 1, ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1,
+};
 
 char *ws_trim_whitespace(char *str) {
-    char *end; 
     if (!str) return NULL;
-    
-    // Trim leading space 
-    while(isspace((unsigned char)*str)) str++; 
-    if(*str == 0) return str; // All spaces
 
-    // Trim trailing space 
-    end = str + strlen(str) - 1; 
-    while(end > str && isspace((unsigned char)*end)) end--;
+    // Trim leading space
+    while (ws_is_space[(unsigned char)*str]) str++;
+    if (*str == 0) return str; // All spaces
 
-    // Write new null terminator 
-    *(end + 1) = 0; 
+    /* Trailing trim in the same forward pass that finds the end: track
+     * the last non-space byte seen instead of running strlen first and
+     * walking back, so the string is traversed once instead of twice. */
+    char *last = str;
+    for (char *p = str + 1; *p; p++) {
+        if (!ws_is_space[(unsigned char)*p]) last = p;
+    }
+
+    // Write new null terminator
+    *(last + 1) = 0;
     return str;
 }
 
+/* ASCII lowercase map: identity everywhere except 'A'..'Z'. The
+ * case-insensitive compares below index this instead of calling
+ * tolower(), which on glibc goes through the per-thread locale pointer
+ * to a table lookup per byte — a dependent load chain and a call the
+ * compiler cannot hoist. One shared 256-byte table stays resident in
+ * L1 across the header compares that hammer these functions.
+ *
+ * An 8-bytes-at-a-time SWAR variant was considered and rejected: word
+ * loads on NUL-terminated strings either read past the terminator
+ * (undefined off the end of the allocation unless alignment-peeled) or
+ * need the zero-byte-detect dance on both operands per step, and the
+ * strings compared here — header names, schemes, host names — are a
+ * handful of bytes, so the setup overhead is never amortized. */
+static const unsigned char ws_lower[256] = {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+     16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+    ' ', '!', '"', '#', '$', '%', '&','\'', '(', ')', '*', '+', ',', '-', '.', '/',
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', ':', ';', '<', '=', '>', '?',
+    '@', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+    'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '[','\\', ']', '^', '_',
+    '`', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+    'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '{', '|', '}', '~', 127,
+    128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+    144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+    160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175,
+    176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+    192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+    208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+    224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+    240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255,
+};
+
 int ws_strcasecmp(const char *s1, const char *s2) {
     if (s1 == s2) return 0;
     if (!s1) return -1;
     if (!s2) return 1;
 
     while (*s1 && *s2) {
-        int c1 = tolower((unsigned char)*s1);
-        int c2 = tolower((unsigned char)*s2);
+        int c1 = ws_lower[(unsigned char)*s1];
+        int c2 = ws_lower[(unsigned char)*s2];
         if (c1 != c2) return c1 - c2;
         s1++;
         s2++;
     }
-    return tolower((unsigned char)*s1) - tolower((unsigned char)*s2);
+    return ws_lower[(unsigned char)*s1] - ws_lower[(unsigned char)*s2];
 }
 
 bool ws_strcheck_prefix(const char *str, const char *prefix) {
     while (*prefix) {
-        if (tolower((unsigned char)*str) != tolower((unsigned char)*prefix)) {
+        if (ws_lower[(unsigned char)*str] != ws_lower[(unsigned char)*prefix]) {
             return false;
         }
         str++;
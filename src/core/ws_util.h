@@ -29,11 +29,22 @@
 #define __WS_UTIL_H__
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #define UNUSED(x) ((void)(x))
 
 char *ws_trim_whitespace(char *str);
 
+/**
+ * @brief Duplicates the first n bytes of a string when the length is
+ * already known, avoiding strdup's redundant strlen rescan.
+ *
+ * @param s The source string (need not be NUL-terminated).
+ * @param n Number of bytes to copy.
+ * @return A NUL-terminated copy (release with zfree), or NULL on failure.
+ */
+char *ws_strdup_n(const char *s, size_t n);
+
 /* 
  * String comparison is case sensitive 
  * s1 > s2 return 1
@@ -3,15 +3,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <signal.h> // For signal handling
+#include <errno.h>  // EAGAIN for the stdin drain loop
+#include <signal.h> // For sigset_t / sigprocmask
 #include <unistd.h> // For sleep
+#include <sys/signalfd.h> // SIGINT delivered as a readable fd
 
 #include <ws_log.h>
 #include <ws_event.h>
 
-// Global event loop pointer for signal handler
-ws_event_loop_t *g_main_loop = NULL;
-
 // Example callback for a timer event
 void my_timer_callback(void *user_data) {
     const char *message = (const char *)user_data;
@@ -28,17 +27,22 @@ void my_io_callback(evutil_socket_t fd, short events, void *user_data) {
     ws_log_info("IO event triggered on FD %d. Events: %d. Context: %s", fd, (int)events, context);
 
     if (events & WS_EV_READ) {
+        /* Drain until EAGAIN rather than taking one 255-byte bite per
+         * wakeup: a burst (e.g. a large paste) is consumed in this single
+         * callback instead of costing one epoll_wait round trip per 255
+         * bytes. Requires the fd to be non-blocking (set in main). */
         char buffer[256];
-        ssize_t bytes_read = read(fd, buffer, sizeof(buffer) - 1);
-        if (bytes_read > 0) {
+        ssize_t bytes_read;
+        while ((bytes_read = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
             buffer[bytes_read] = '\0';
             ws_log_info("Read from FD %d: '%s'", fd, buffer);
-        } else if (bytes_read == 0) {
+        }
+        if (bytes_read == 0) {
             ws_log_info("EOF on FD %d. Removing IO event.", fd);
             ws_event_del( (ws_event_t*)user_data ); // NOTE: In real code, user_data shouldn't be the event itself.
                                                     // Pass the ws_event_t pointer as part of a custom struct.
             ws_event_free( (ws_event_t*)user_data ); // Then free the event.
-        } else {
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
             ws_log_error("Error reading from FD %d.", fd);
         }
     }
@@ -50,31 +54,44 @@ void my_io_callback(evutil_socket_t fd, short events, void *user_data) {
     // For demonstration, `ws_log_info` works, but cleanup needs care.
 }
 
-// Signal handler to gracefully stop the loop
-void signal_handler(int sig) {
-    if (sig == SIGINT) {
+/* SIGINT arrives through a signalfd watched like any other fd, so this
+ * runs as a normal event callback — no async-signal context, no
+ * restrictions on what it may call (ws_event_loop_stop pokes libevent
+ * internals that a raw signal handler has no business touching). */
+void signal_fd_callback(evutil_socket_t fd, short events, void *user_data) {
+    ws_event_loop_t *loop = (ws_event_loop_t *)user_data;
+    struct signalfd_siginfo si;
+    (void)events;
+
+    if (read(fd, &si, sizeof(si)) == (ssize_t)sizeof(si) && si.ssi_signo == SIGINT) {
         ws_log_info("SIGINT received. Shutting down event loop...");
-        if (g_main_loop) {
-            ws_event_loop_stop(g_main_loop);
-        } else {
-            exit(EXIT_SUCCESS);
-        }
+        ws_event_loop_stop(loop);
     }
 }
 
 int main() {
-    // Set up signal handler
-    if (signal(SIGINT, signal_handler) == SIG_ERR) {
-        ws_log_error("Failed to set SIGINT handler.");
+    /* Route SIGINT through a signalfd instead of signal(): the signal
+     * must be blocked so it is only delivered via the fd, which the
+     * event loop then watches like stdin below. */
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {
+        ws_log_error("Failed to block SIGINT.");
+        return EXIT_FAILURE;
+    }
+    int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (sfd == -1) {
+        ws_log_error("Failed to create signalfd for SIGINT.");
         return EXIT_FAILURE;
     }
 
     // 1. Create an event loop
     ws_event_loop_t *loop = ws_event_loop_new();
     if (!loop) {
+        close(sfd);
         return EXIT_FAILURE;
     }
-    g_main_loop = loop; // Set global for signal handler
 
     // 2. Create and add a persistent timer event
     ws_event_t *timer_event = ws_event_new_timer(loop, 2000, true, my_timer_callback, "2-second persistent timer");
@@ -91,25 +108,37 @@ int main() {
         // Continue but cleanup on exit
     }
 
-    // 4. Create and add an I/O event to monitor standard input (FD 0)
+    // 4. Create and add an I/O event to monitor standard input (FD 0).
+    // stdin must be non-blocking so the callback's drain loop can stop
+    // at EAGAIN instead of blocking the whole event loop.
     // NOTE: Passing `one_shot_timer` as user_data for demo,
     // in real app, you'd pass a custom struct or context.
+    evutil_make_socket_nonblocking(STDIN_FILENO);
     ws_event_t *stdin_event = ws_event_new_io(loop, STDIN_FILENO, WS_EV_READ | WS_EV_PERSIST, my_io_callback, "stdin_monitor");
     if (!stdin_event || !ws_event_add(stdin_event)) {
         ws_log_error("Failed to add stdin IO event.");
         // Continue but cleanup on exit
     }
 
+    // 5. Watch the signalfd so Ctrl+C stops the loop from event context
+    ws_event_t *signal_event = ws_event_new_io(loop, sfd, WS_EV_READ | WS_EV_PERSIST, signal_fd_callback, loop);
+    if (!signal_event || !ws_event_add(signal_event)) {
+        ws_log_error("Failed to add signalfd IO event.");
+        // Continue but cleanup on exit
+    }
+
     ws_log_info("Event loop initialized. Press Ctrl+C to stop, or type something and press Enter.");
 
-    // 5. Dispatch the event loop (this blocks until ws_event_loop_stop() is called)
+    // 6. Dispatch the event loop (this blocks until ws_event_loop_stop() is called)
     ws_event_loop_dispatch(loop);
 
-    // 6. Cleanup
+    // 7. Cleanup
     ws_log_info("Cleaning up events and loop...");
     ws_event_free(timer_event);     // Free persistent timer
     ws_event_free(one_shot_timer);  // Free one-shot timer (already triggered or not)
     ws_event_free(stdin_event);     // Free stdin event
+    ws_event_free(signal_event);    // Free signalfd event
+    close(sfd);
     ws_event_loop_free(loop);
     
     ws_log_info("Application exited.");
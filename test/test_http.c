@@ -3,8 +3,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <signal.h>
+#include <signal.h> // For sigset_t / sigprocmask
 #include <unistd.h> // For sleep
+#include <sys/signalfd.h> // SIGINT delivered as a readable fd
 #include <ws_log.h>
 #include <ws_event.h>
 #include <ws_http.h>
@@ -13,67 +14,121 @@
 ws_event_loop_t *g_main_loop = NULL;
 ws_http_client_t *g_http_client = NULL;
 
-// Store received data (for simplicity, in a real app use dynamic buffer)
-char g_response_buffer[4096];
-size_t g_response_len = 0;
+// Per-request state, carried through user_data instead of globals: the
+// multi interface runs requests concurrently, so a single shared buffer
+// would interleave the bodies of overlapping responses. One context per
+// in-flight request keeps the callbacks correct (and lock-free) at any
+// concurrency. The buffer grows on demand; the old fixed 4KB array
+// silently truncated larger bodies.
+typedef struct {
+    const char *name;   // Human-readable label for log lines
+    char *buf;          // Grow-on-demand body accumulator
+    size_t len;
+    size_t cap;
+} request_ctx_t;
+
+static request_ctx_t *request_ctx_new(const char *name) {
+    request_ctx_t *ctx = calloc(1, sizeof(*ctx));
+    if (ctx) ctx->name = name;
+    return ctx;
+}
+
+static void request_ctx_free(request_ctx_t *ctx) {
+    if (!ctx) return;
+    free(ctx->buf);
+    free(ctx);
+}
 
 // --- HTTP Callbacks ---
 
 void my_http_header_callback(const char *header, void *user_data) {
-    ws_log_debug("Header (Context: %s): %s", (char*)user_data, header);
+    request_ctx_t *ctx = (request_ctx_t *)user_data;
+    ws_log_debug("Header (Context: %s): %s", ctx->name, header);
 }
 
 void my_http_data_callback(const char *data, size_t size, void *user_data) {
-    (void)user_data;
-    // For demonstration, accumulate data. In real apps, handle streaming.
-    if (g_response_len + size < sizeof(g_response_buffer)) {
-        memcpy(g_response_buffer + g_response_len, data, size);
-        g_response_len += size;
-    } else {
-        ws_log_warn("Response buffer full, discarding data.");
+    request_ctx_t *ctx = (request_ctx_t *)user_data;
+    // The API contract is already streaming: this callback receives each
+    // chunk as it arrives, aliasing libcurl's buffer, so a consumer that
+    // can scan incrementally does so here with O(1) memory and no copy.
+    // Accumulating to completion is this demo's choice (it prints the
+    // whole body), not something the layer imposes.
+    // That aliasing is also why the copy below cannot become an iovec
+    // list of retained (ptr, len) pairs: the pointer is only valid for
+    // the duration of this callback (libcurl reuses its receive buffer
+    // for the next chunk), so anything consumed after returning must be
+    // copied now — deferred scatter-gather over these pointers would
+    // read recycled memory.
+    // Accumulate data, growing the buffer geometrically so N chunks cost
+    // O(log N) reallocs. +1 keeps room for the terminating NUL added on
+    // completion without a separate grow there.
+    if (ctx->len + size + 1 > ctx->cap) {
+        size_t new_cap = ctx->cap ? ctx->cap : 4096;
+        while (new_cap < ctx->len + size + 1) {
+            new_cap *= 2;
+        }
+        char *new_buf = realloc(ctx->buf, new_cap);
+        if (!new_buf) {
+            ws_log_warn("Response buffer grow failed, discarding data.");
+            return;
+        }
+        ctx->buf = new_buf;
+        ctx->cap = new_cap;
     }
+    memcpy(ctx->buf + ctx->len, data, size);
+    ctx->len += size;
 }
 
 void my_http_complete_callback(ws_http_request_t *request, long http_code, CURLcode curl_code, void *user_data) {
     (void)request;
-    const char *context = (const char *)user_data;
-    ws_log_info("HTTP request (Context: %s) completed.", context);
+    request_ctx_t *ctx = (request_ctx_t *)user_data;
+    // No explicit level guard needed around curl_easy_strerror: the
+    // ws_log_* macros compile the level check around the whole call, so
+    // when a level is filtered out none of the arguments are evaluated —
+    // the strerror lookup (and the debug body render below) cost nothing.
+    ws_log_info("HTTP request (Context: %s) completed.", ctx->name);
     ws_log_info("  HTTP Status: %ld", http_code);
     ws_log_info("  Curl Result: %d (%s)", (int)curl_code, curl_easy_strerror(curl_code));
 
-    if (curl_code == CURLE_OK) {
-        // Null-terminate the accumulated response data for printing
-        g_response_buffer[g_response_len] = '\0';
-        ws_log_info("  Response Body (%zu bytes):\n%s", g_response_len, g_response_buffer);
-    } else {
+    if (curl_code == CURLE_OK && ctx->buf) {
+        // Null-terminate the accumulated response data for printing.
+        // Body dump is debug-level: the %s formatting of a multi-KB body
+        // is skipped entirely at the call site unless a sink wants it.
+        ctx->buf[ctx->len] = '\0';
+        ws_log_info("  Response Body: %zu bytes", ctx->len);
+        ws_log_debug("  Response Body content:\n%s", ctx->buf);
+    } else if (curl_code != CURLE_OK) {
         ws_log_error("  HTTP request failed.");
     }
 
-    // Reset buffer for next request
-    g_response_len = 0;
-    memset(g_response_buffer, 0, sizeof(g_response_buffer));
+    // The context's lifetime is the request's: freed here, so each
+    // request's state is independent and nothing persists between them.
+    request_ctx_free(ctx);
 }
 
 // --- Global Timer Callback (for general app logic, not curl internal) ---
+// One-shot: the old version ticked every second and counted to three
+// before stopping, which woke the loop (and libcurl's socket action)
+// twice for nothing. A single timer at the full deadline does the same
+// job with one wakeup and no static counter.
 void app_timer_callback(void *user_data) {
-    (void)user_data;
-    static int count = 0;
-    ws_log_info("Application timer fired! Count: %d", ++count);
-    if (count == 3) {
-        ws_log_info("Time to stop the loop!");
-        ws_event_loop_stop(g_main_loop);
-    }
+    ws_event_loop_t *loop = (ws_event_loop_t *)user_data;
+    ws_log_info("Application timer fired. Time to stop the loop!");
+    ws_event_loop_stop(loop);
 }
 
-// --- Signal Handler ---
-void signal_handler(int sig) {
-    if (sig == SIGINT) {
+/* SIGINT arrives through a signalfd watched like any other fd, so this
+ * runs as a normal event callback. The old signal() handler called
+ * ws_event_loop_stop from async-signal context, which is undefined —
+ * it pokes libevent internals that are not async-signal-safe. */
+void signal_fd_callback(evutil_socket_t fd, short events, void *user_data) {
+    ws_event_loop_t *loop = (ws_event_loop_t *)user_data;
+    struct signalfd_siginfo si;
+    (void)events;
+
+    if (read(fd, &si, sizeof(si)) == (ssize_t)sizeof(si) && si.ssi_signo == SIGINT) {
         ws_log_info("SIGINT received. Shutting down event loop...");
-        if (g_main_loop) {
-            ws_event_loop_stop(g_main_loop);
-        } else {
-            exit(EXIT_SUCCESS);
-        }
+        ws_event_loop_stop(loop);
     }
 }
 
@@ -81,18 +136,36 @@ int main() {
     // 0. Set up logging (optional, but good for debugging)
     // ws_log_set_level(WS_LOG_INFO); // Set to WS_LOG_DEBUG for more verbosity
 
-    // Set up signal handler
-    if (signal(SIGINT, signal_handler) == SIG_ERR) {
-        ws_log_error("Failed to set SIGINT handler.");
+    // Route SIGINT through a signalfd instead of signal(): the signal
+    // must be blocked so it is only delivered via the fd, which the
+    // event loop then watches like any other descriptor.
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {
+        ws_log_error("Failed to block SIGINT.");
+        return EXIT_FAILURE;
+    }
+    int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (sfd == -1) {
+        ws_log_error("Failed to create signalfd for SIGINT.");
         return EXIT_FAILURE;
     }
 
     // 1. Create an event loop
     g_main_loop = ws_event_loop_new();
     if (!g_main_loop) {
+        close(sfd);
         return EXIT_FAILURE;
     }
 
+    // Watch the signalfd so Ctrl+C stops the loop from event context
+    ws_event_t *signal_event = ws_event_new_io(g_main_loop, sfd, WS_EV_READ | WS_EV_PERSIST, signal_fd_callback, g_main_loop);
+    if (!signal_event || !ws_event_add(signal_event)) {
+        ws_log_error("Failed to add signalfd IO event.");
+        // Continue anyway; Ctrl+C just won't stop the loop gracefully
+    }
+
     // 2. Create an HTTP client, linking it to our event loop
     g_http_client = ws_http_client_new(g_main_loop);
     if (!g_http_client) {
@@ -101,7 +174,7 @@ int main() {
     }
 
     // 3. Create an application timer (independent of curl's internal timers)
-    // ws_event_t *app_timer = ws_event_new_timer(g_main_loop, 1000, true, app_timer_callback, "App Timer Context");
+    // ws_event_t *app_timer = ws_event_new_timer(g_main_loop, 3000, false, app_timer_callback, g_main_loop);
     // if (!app_timer || !ws_event_add(app_timer)) {
     //     ws_log_error("Failed to add application timer.");
     // }
@@ -110,21 +183,33 @@ int main() {
     // IMPORTANT: Use URLs that are accessible. For testing, 'http://example.com' or a local server.
     // Be aware of firewalls/proxies.
     // ws_log_info("Making GET request to http://example.com");
-    ws_http_get(g_http_client, "https://www.baidu.com",
-                my_http_header_callback,
-                my_http_data_callback,
-                my_http_complete_callback,
-                "GET Request Context");
+    request_ctx_t *get_ctx = request_ctx_new("GET Request Context");
+    if (!get_ctx ||
+        !ws_http_get(g_http_client, "https://www.baidu.com",
+                     my_http_header_callback,
+                     my_http_data_callback,
+                     my_http_complete_callback,
+                     get_ctx)) {
+        ws_log_error("Failed to start GET request.");
+        request_ctx_free(get_ctx); // Complete callback will never run
+    }
 
-    // 5. Make an asynchronous HTTP POST request
+    // 5. Make an asynchronous HTTP POST request. The form writer encodes
+    // key/value pairs into a stack buffer — no malloc, and the tracked
+    // length goes straight to ws_http_post without a strlen scan.
     // ws_log_info("Making POST request to http://httpbin.org/post");
-    // const char *post_data = "key1=value1&key2=value2";
+    // char form_buf[256];
+    // ws_http_form_writer_t form;
+    // ws_http_form_init(&form, form_buf, sizeof(form_buf));
+    // ws_http_form_append_kv(&form, "key1", "value1");
+    // ws_http_form_append_kv(&form, "key2", "value2");
+    // request_ctx_t *post_ctx = request_ctx_new("POST Request Context");
     // ws_http_post(g_http_client, "http://httpbin.org/post",
-    //              post_data, strlen(post_data),
+    //              form.buf, form.len,
     //              my_http_header_callback,
     //              my_http_data_callback,
     //              my_http_complete_callback,
-    //              "POST Request Context");
+    //              post_ctx);
 
     // 6. Dispatch the event loop
     ws_log_info("Starting main event loop dispatch...");
@@ -134,6 +219,8 @@ int main() {
     ws_log_info("Main loop stopped. Cleaning up resources...");
     ws_http_client_free(g_http_client); // This will also free any pending requests
     // ws_event_free(app_timer);           // Free app timer
+    if (signal_event) ws_event_free(signal_event);
+    close(sfd);
     ws_event_loop_free(g_main_loop);
 
     // Call curl_global_cleanup only once at the very end of your application's lifecycle.